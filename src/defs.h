@@ -39,14 +39,27 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define MAP_WIDTH    108
 #define MAP_HEIGHT   15
 
-#define MAP_RENDER_WIDTH    27
-#define MAP_RENDER_HEIGHT   15
+#define SOLID_ROW_WORDS   ((MAP_WIDTH + 63) / 64)
+
+#define MAP_CHUNK_WIDTH   9
+#define MAP_CHUNK_SLOTS   5
 
 #define PLAYER_MOVE_SPEED 6
 
+#define MAX_PARTICLES   1024
+
 #define MAX_TIPS    12
 
-#define MAX_QT_CANDIDATES   128
+#define ENTITY_BLOCK_SIZE   64
+#define DATA_BLOCK_SIZE     16
+
+#define GRID_CELL_SIZE   (TILE_SIZE * 2)
+#define GRID_WIDTH       (((MAP_WIDTH * TILE_SIZE) + GRID_CELL_SIZE - 1) / GRID_CELL_SIZE)
+#define GRID_HEIGHT      (((MAP_HEIGHT * TILE_SIZE) + GRID_CELL_SIZE - 1) / GRID_CELL_SIZE)
+
+#define STATIC_BROADPHASE_MARGIN   16
+
+#define SLEEP_FRAMES   10
 
 #define MAX_NAME_LENGTH           32
 #define MAX_DESCRIPTION_LENGTH    256
@@ -70,6 +83,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define EF_NO_ENT_CLIP     (2 << 7)
 #define EF_INVISIBLE       (2 << 8)
 #define EF_STATIC          (2 << 9)
+#define EF_KINEMATIC       (2 << 10)
 
 enum
 {
@@ -85,6 +99,45 @@ enum
 	ET_DECORATION
 };
 
+enum
+{
+	BP_QUADTREE,
+	BP_GRID,
+	BP_MAX
+};
+
+enum
+{
+	BPI_NONE,
+	BPI_DYNAMIC,
+	BPI_STATIC
+};
+
+enum
+{
+	ED_COLLECTABLE,
+	ED_DECORATION,
+	ED_DOOR,
+	ED_ITEM,
+	ED_PLATFORM,
+	ED_PRESSURE_PLATE,
+	ED_SPITTER,
+	ED_TOILET,
+	ED_TRAFFIC_LIGHT,
+	ED_WALTER,
+	ED_WATER_BUTTON,
+	ED_MAX
+};
+
+enum
+{
+	TS_IDLE,
+	TS_STINK,
+	TS_ERUPT,
+	TS_ESCAPE,
+	TS_PLUNGING
+};
+
 enum
 {
 	EQ_NONE,
@@ -114,6 +167,27 @@ enum
 	TEXT_RIGHT
 };
 
+enum
+{
+	RC_QUAD,
+	RC_RECT,
+	RC_OUTLINE_RECT,
+	RC_TEXT,
+	RC_CHUNKS
+};
+
+/* draw commands are submitted in this order, and in the order they were made within each layer */
+enum
+{
+	LAYER_BACKGROUND,
+	LAYER_BACKGROUND_ENTITIES,
+	LAYER_MAP,
+	LAYER_ENTITIES,
+	LAYER_PARTICLES,
+	LAYER_OVERLAY,
+	LAYER_MAX
+};
+
 enum
 {
 	FACING_LEFT,
@@ -29,29 +29,28 @@ int isValidCloneFrame(Walter *c);
 static void tick(void);
 static void die(void);
 
+static EntityOps ops = {tick, NULL, NULL, die, NULL, NULL, NULL};
+
 void initClone(void)
 {
 	Entity *e;
 	Walter *c;
 
-	c = malloc(sizeof(Walter));
-	memset(c, 0, sizeof(Walter));
+	e = spawnEntity();
+
+	c = allocEntityData(e, ED_WALTER);
 
 	c->dataHead = stage.cloneDataHead.next;
 
 	stage.cloneDataHead.next = NULL;
 
-	e = spawnEntity();
-
 	e->typeName = "clone";
 	e->type = ET_CLONE;
 	e->atlasImage = getAtlasImage("gfx/entities/clone.png", 1);
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
 	e->flags = EF_PUSH+EF_PUSHABLE+EF_SLOW_PUSH;
-	e->data = c;
-	e->tick = tick;
-	e->die = die;
+	e->ops = &ops;
 
 	normalTexture = e->atlasImage;
 
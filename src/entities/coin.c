@@ -24,25 +24,23 @@ static void tick(void);
 static void touch(Entity *other);
 static void die(void);
 
+static EntityOps ops = {tick, touch, NULL, die, NULL, NULL, NULL};
+
 void initCoin(Entity *e)
 {
 	Collectable *c;
 
-	c = malloc(sizeof(Collectable));
-	memset(c, 0, sizeof(Collectable));
+	c = allocEntityData(e, ED_COLLECTABLE);
 
 	c->bobValue = rand() % 10;
 
 	e->typeName = "coin";
 	e->type = ET_ITEM;
-	e->data = c;
 	e->atlasImage = getAtlasImage("gfx/entities/coin.png", 1);
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
 	e->flags = EF_WEIGHTLESS+EF_NO_ENT_CLIP+EF_STATIC;
-	e->tick = tick;
-	e->touch = touch;
-	e->die = die;
+	e->ops = &ops;
 
 	e->light.r = 255;
 	e->light.g = 255;
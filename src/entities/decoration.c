@@ -23,26 +23,25 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 static void load(cJSON *root);
 static void save(cJSON *root);
 
+static EntityOps ops = {NULL, NULL, NULL, NULL, NULL, load, save};
+
 void initDecoration(Entity *e)
 {
 	Decoration *d;
 
-	d = malloc(sizeof(Decoration));
-	memset(d, 0, sizeof(Decoration));
+	d = allocEntityData(e, ED_DECORATION);
 
 	STRNCPY(d->textureFilename, "gfx/decoration/cabinet.png", MAX_NAME_LENGTH);
 
 	e->typeName = "decoration";
 	e->type = ET_DECORATION;
-	e->data = d;
 	e->facing = 1;
 	e->atlasImage = getAtlasImage(d->textureFilename, 1);
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
 	e->flags = EF_WEIGHTLESS+EF_NO_ENT_CLIP+EF_STATIC;
 
-	e->load = load;
-	e->save = save;
+	e->ops = &ops;
 }
 
 static void load(cJSON *root)
@@ -22,16 +22,18 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 static void tick(void);
 static void activate(int active);
+static int canSleep(void);
 static void touch(Entity *other);
 static void load(cJSON *root);
 static void save(cJSON *root);
 
+static EntityOps ops = {tick, touch, activate, NULL, canSleep, load, save};
+
 void initDoor(Entity *e)
 {
 	Door *d;
 
-	d = malloc(sizeof(Door));
-	memset(d, 0, sizeof(Door));
+	d = allocEntityData(e, ED_DOOR);
 
 	d->sx = e->x;
 	d->sy = e->y;
@@ -40,21 +42,15 @@ void initDoor(Entity *e)
 
 	e->typeName = "door";
 	e->type = ET_STRUCTURE;
-	e->data = d;
-	e->tick = tick;
-	e->activate = activate;
-	e->touch = touch;
+	e->ops = &ops;
 	e->atlasImage = getAtlasImage("gfx/entities/door.png", 1);
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
-	e->flags = EF_SOLID+EF_WEIGHTLESS+EF_PUSH+EF_NO_WORLD_CLIP;
+	e->flags = EF_SOLID+EF_WEIGHTLESS+EF_PUSH+EF_NO_WORLD_CLIP+EF_KINEMATIC;
 	e->background = 1;
 
 	/* when opened */
 	d->ey = e->y - (e->h - 4);
-
-	e->load = load;
-	e->save = save;
 }
 
 static void tick(void)
@@ -101,6 +97,12 @@ static void activate(int active)
 	playPositionalSound(SND_DOOR, CH_STRUCTURE, self->x, self->y, stage.player->x, stage.player->y);
 }
 
+/* a door at rest only moves again once it is opened or closed */
+static int canSleep(void)
+{
+	return 1;
+}
+
 static void touch(Entity *other)
 {
 	Door *d;
@@ -22,22 +22,20 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 static void touch(Entity *other);
 
+static EntityOps ops = {NULL, touch, NULL, NULL, NULL, NULL, NULL};
+
 void initFinalToilet(Entity *e)
 {
-	Toilet *t;
-
-	t = malloc(sizeof(Toilet));
-	memset(t, 0, sizeof(Toilet));
+	allocEntityData(e, ED_TOILET);
 
 	e->typeName = "finalToilet";
 	e->facing = 0;
 	e->type = ET_TOILET;
-	e->data = t;
 	e->atlasImage = getAtlasImage("gfx/entities/toilet.png", 1);
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
 	e->flags = EF_NO_ENT_CLIP+EF_STATIC;
-	e->touch = touch;
+	e->ops = &ops;
 }
 
 static void touch(Entity *other)
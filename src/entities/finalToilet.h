@@ -21,6 +21,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "../common.h"
 #include "../json/cJSON.h"
 
+extern void *allocEntityData(Entity *e, int dataType);
 extern AtlasImage *getAtlasImage(char *filename, int required);
 
 extern Stage stage;
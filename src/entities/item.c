@@ -26,12 +26,13 @@ static void die(void);
 static void load(cJSON *root);
 static void save(cJSON *root);
 
+static EntityOps ops = {tick, touch, NULL, die, NULL, load, save};
+
 void initItem(Entity *e)
 {
 	Item *i;
 
-	i = malloc(sizeof(Item));
-	memset(i, 0, sizeof(Item));
+	i = allocEntityData(e, ED_ITEM);
 
 	STRNCPY(i->textureFilename, "gfx/entities/item01.png", MAX_NAME_LENGTH);
 
@@ -39,17 +40,11 @@ void initItem(Entity *e)
 
 	e->typeName = "item";
 	e->type = ET_ITEM;
-	e->data = i;
 	e->atlasImage = getAtlasImage(i->textureFilename, 1);
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
 	e->flags = EF_WEIGHTLESS+EF_NO_ENT_CLIP+EF_STATIC;
-	e->tick = tick;
-	e->touch = touch;
-	e->die = die;
-
-	e->load = load;
-	e->save = save;
+	e->ops = &ops;
 
 	e->light.r = 255;
 	e->light.b = 255;
@@ -23,24 +23,23 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 static void tick(void);
 static void touch(Entity *other);
 
+static EntityOps ops = {tick, touch, NULL, NULL, NULL, NULL, NULL};
+
 void initKey(Entity *e)
 {
 	Collectable *k;
 
-	k = malloc(sizeof(Collectable));
-	memset(k, 0, sizeof(Collectable));
+	k = allocEntityData(e, ED_COLLECTABLE);
 
 	k->bobValue = rand() % 10;
 
 	e->typeName = "key";
 	e->type = ET_ITEM;
-	e->data = k;
 	e->atlasImage = getAtlasImage("gfx/entities/key.png", 1);
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
 	e->flags = EF_WEIGHTLESS+EF_NO_ENT_CLIP+EF_STATIC;
-	e->tick = tick;
-	e->touch = touch;
+	e->ops = &ops;
 
 	e->light.r = 255;
 	e->light.g = 128;
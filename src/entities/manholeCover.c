@@ -24,25 +24,23 @@ static void tick(void);
 static void touch(Entity *other);
 static void die(void);
 
+static EntityOps ops = {tick, touch, NULL, die, NULL, NULL, NULL};
+
 void initManholeCover(Entity *e)
 {
 	Collectable *m;
 
-	m = malloc(sizeof(Collectable));
-	memset(m, 0, sizeof(Collectable));
+	m = allocEntityData(e, ED_COLLECTABLE);
 
 	m->bobValue = rand() % 10;
 
 	e->typeName = "manholeCover";
 	e->type = ET_ITEM;
-	e->data = m;
 	e->atlasImage = getAtlasImage("gfx/entities/manholeCover.png", 1);
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
 	e->flags = EF_WEIGHTLESS+EF_NO_ENT_CLIP+EF_STATIC;
-	e->tick = tick;
-	e->touch = touch;
-	e->die = die;
+	e->ops = &ops;
 
 	e->light.r = e->light.g = e->light.b = 255;
 	e->light.a = 64;
@@ -22,15 +22,17 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 static void tick(void);
 static void activate(int active);
+static int canSleep(void);
 static void load(cJSON *root);
 static void save(cJSON *root);
 
+static EntityOps ops = {tick, NULL, activate, NULL, canSleep, load, save};
+
 void initPlatform(Entity *e)
 {
 	Platform *p;
 
-	p = malloc(sizeof(Platform));
-	memset(p, 0, sizeof(Platform));
+	p = allocEntityData(e, ED_PLATFORM);
 
 	/* defaults */
 	p->sx = e->x;
@@ -42,16 +44,11 @@ void initPlatform(Entity *e)
 
 	e->typeName = "platform";
 	e->type = ET_STRUCTURE;
-	e->data = p;
-	e->tick = tick;
-	e->activate = activate;
+	e->ops = &ops;
 	e->atlasImage = getAtlasImage("gfx/entities/platform.png", 1);
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
-	e->flags = EF_SOLID+EF_WEIGHTLESS+EF_PUSH;
-
-	e->load = load;
-	e->save = save;
+	e->flags = EF_SOLID+EF_WEIGHTLESS+EF_PUSH+EF_KINEMATIC;
 }
 
 static void tick(void)
@@ -125,6 +122,15 @@ static void activate(int active)
 	p->enabled = !p->enabled;
 }
 
+static int canSleep(void)
+{
+	Platform *p;
+
+	p = (Platform*)self->data;
+
+	return !p->enabled;
+}
+
 static void load(cJSON *root)
 {
 	Platform *p;
@@ -26,6 +26,8 @@ static void die(void);
 void fireWaterPistol(void);
 static void load(cJSON *root);
 static void save(cJSON *root);
+static void bulletTouch(Entity *other);
+static void bulletDie(void);
 
 static AtlasImage *normalTexture;
 static AtlasImage *shieldTexture;
@@ -34,25 +36,21 @@ static AtlasImage *waterPistolTexture;
 static AtlasImage *bulletTexture;
 static float px;
 static float py;
+static EntityOps ops = {tick, NULL, NULL, die, NULL, load, save};
+static EntityOps bulletOps = {NULL, bulletTouch, NULL, bulletDie, NULL, NULL, NULL};
 
 void initPlayer(Entity *e)
 {
-	Walter *p;
 
 	stage.player = e;
 
-	p = malloc(sizeof(Walter));
-	memset(p, 0, sizeof(Walter));
+	allocEntityData(e, ED_WALTER);
 
 	e->typeName = "player";
-	e->data = p;
 	e->type = ET_PLAYER;
 	e->atlasImage = getAtlasImage("gfx/entities/guy.png", 1);
 	e->flags = EF_PUSH+EF_PUSHABLE+EF_SLOW_PUSH;
-	e->tick = tick;
-	e->die = die;
-	e->load = load;
-	e->save = save;
+	e->ops = &ops;
 
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
@@ -259,8 +257,7 @@ void fireWaterPistol(void)
 	e->atlasImage = bulletTexture;
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
-	e->touch = bulletTouch;
-	e->die = bulletDie;
+	e->ops = &bulletOps;
 
 	e->y += (e->h / 2);
 
@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 extern void addDeathParticles(int x, int y);
 extern void addWaterBurstParticles(int x, int y);
+extern void *allocEntityData(Entity *e, int dataType);
 extern void clearControl(int type);
 extern AtlasImage *getAtlasImage(char *filename, int required);
 extern int isControl(int type);
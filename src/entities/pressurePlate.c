@@ -27,30 +27,24 @@ static void touch(Entity *other);
 
 static AtlasImage *idleTexture;
 static AtlasImage *activeTexture;
+static EntityOps ops = {tick, touch, NULL, NULL, NULL, load, save};
 
 void initPressurePlate(Entity *e)
 {
-	PressurePlate *p;
 
 	idleTexture = getAtlasImage("gfx/entities/pressurePlateIdle.png", 1);
 	activeTexture = getAtlasImage("gfx/entities/pressurePlateActive.png", 1);
 
-	p = malloc(sizeof(PressurePlate));
-	memset(p, 0, sizeof(PressurePlate));
+	allocEntityData(e, ED_PRESSURE_PLATE);
 
 	e->typeName = "pressurePlate";
 	e->type = ET_STRUCTURE;
-	e->data = p;
-	e->tick = tick;
-	e->touch = touch;
+	e->ops = &ops;
 	e->atlasImage = idleTexture;
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
 	e->flags = EF_SOLID+EF_WEIGHTLESS+EF_STATIC;
 
-	e->load = load;
-	e->save = save;
-
 	e->light.r = 128;
 	e->light.g = 192;
 	e->light.b = 255;
@@ -72,7 +66,7 @@ static void tick(void)
 	{
 		if (prevWeight > 0)
 		{
-			activeEntities(p->targetName, 0);
+			activeEntities(p->wire, 0);
 		}
 
 		self->atlasImage = idleTexture;
@@ -97,7 +91,7 @@ static void touch(Entity *other)
 
 		if (p->weight == 0)
 		{
-			activeEntities(p->targetName, 1);
+			activeEntities(p->wire, 1);
 
 			playPositionalSound(SND_PRESSURE_PLATE, CH_SWITCH, self->x, self->y, stage.player->x, stage.player->y);
 		}
@@ -113,6 +107,8 @@ static void load(cJSON *root)
 	p = (PressurePlate*)self->data;
 
 	STRNCPY(p->targetName, cJSON_GetObjectItem(root, "targetName")->valuestring, MAX_NAME_LENGTH);
+
+	p->wire = getWire(p->targetName);
 }
 
 static void save(cJSON *root)
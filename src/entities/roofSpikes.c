@@ -22,6 +22,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 static void touch(Entity *other);
 
+static EntityOps ops = {NULL, touch, NULL, NULL, NULL, NULL, NULL};
+
 void initRoofSpikes(Entity *e)
 {
 	e->typeName = "roofSpikes";
@@ -29,7 +31,7 @@ void initRoofSpikes(Entity *e)
 	e->atlasImage = getAtlasImage("gfx/entities/roofSpikes.png", 1);
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
-	e->touch = touch;
+	e->ops = &ops;
 	e->flags = EF_WEIGHTLESS+EF_NO_ENT_CLIP+EF_STATIC;
 }
 
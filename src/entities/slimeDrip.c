@@ -24,25 +24,25 @@ static void tick(void);
 static void fireBullet(void);
 static void load(cJSON *root);
 static void save(cJSON *root);
+static void bulletTick(void);
+static void bulletTouch(Entity *other);
+static void bulletDie(void);
+
+static EntityOps ops = {tick, NULL, NULL, NULL, NULL, load, save};
+static EntityOps bulletOps = {bulletTick, NULL, NULL, bulletDie, NULL, NULL, NULL};
+static EntityOps fallingBulletOps = {bulletTick, bulletTouch, NULL, bulletDie, NULL, NULL, NULL};
 
 void initSlimeDrip(Entity *e)
 {
-	Spitter *s;
-
-	s = malloc(sizeof(Spitter));
-	memset(s, 0, sizeof(Spitter));
+	allocEntityData(e, ED_SPITTER);
 
 	e->typeName = "slimeDrip";
 	e->type = ET_TRAP;
-	e->data = s;
 	e->atlasImage = getAtlasImage("gfx/entities/drip.png", 1);
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
 	e->flags = EF_WEIGHTLESS+EF_NO_ENT_CLIP+EF_INVISIBLE+EF_STATIC;
-	e->tick = tick;
-
-	e->load = load;
-	e->save = save;
+	e->ops = &ops;
 }
 
 static void tick(void)
@@ -121,7 +121,7 @@ static void bulletTick(void)
 
 		if (--self->health == 1)
 		{
-			self->touch = bulletTouch;
+			self->ops = &fallingBulletOps;
 
 			self->flags &= ~EF_WEIGHTLESS;
 			self->flags &= ~EF_NO_WORLD_CLIP;
@@ -149,8 +149,7 @@ static void fireBullet(void)
 	e->background = 1;
 	e->flags = EF_WEIGHTLESS+EF_NO_WORLD_CLIP+EF_NO_ENT_CLIP;
 	e->health = FPS;
-	e->tick = bulletTick;
-	e->die = bulletDie;
+	e->ops = &bulletOps;
 
 	e->y -= e->h * 2;
 
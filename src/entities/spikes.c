@@ -22,6 +22,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 static void touch(Entity *other);
 
+static EntityOps ops = {NULL, touch, NULL, NULL, NULL, NULL, NULL};
+
 void initSpikes(Entity *e)
 {
 	e->typeName = "spikes";
@@ -29,7 +31,7 @@ void initSpikes(Entity *e)
 	e->atlasImage = getAtlasImage("gfx/entities/spikes.png", 1);
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
-	e->touch = touch;
+	e->ops = &ops;
 	e->flags = EF_NO_ENT_CLIP+EF_STATIC;
 }
 
@@ -22,33 +22,30 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 static void tick(void);
 static void activate(int active);
+static int canSleep(void);
 static void fireBullet(void);
 static void load(cJSON *root);
 static void save(cJSON *root);
+static void bulletTouch(Entity *other);
+static void bulletDie(void);
 
 static AtlasImage *bulletTexture;
+static EntityOps ops = {tick, NULL, activate, NULL, canSleep, load, save};
+static EntityOps bulletOps = {NULL, bulletTouch, NULL, bulletDie, NULL, NULL, NULL};
 
 void initSpitter(Entity *e)
 {
-	Spitter *s;
-
-	s = malloc(sizeof(Spitter));
-	memset(s, 0, sizeof(Spitter));
+	allocEntityData(e, ED_SPITTER);
 
 	e->typeName = "spitter";
 	e->type = ET_TRAP;
-	e->data = s;
 	e->atlasImage = getAtlasImage("gfx/entities/spitter.png", 1);
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
 	e->flags = EF_WEIGHTLESS+EF_NO_ENT_CLIP+EF_STATIC;
-	e->tick = tick;
-	e->activate = activate;
+	e->ops = &ops;
 
 	bulletTexture = getAtlasImage("gfx/entities/spitterBullet.png", 1);
-
-	e->load = load;
-	e->save = save;
 }
 
 static void tick(void)
@@ -76,6 +73,15 @@ static void activate(int active)
 	s->enabled = !s->enabled;
 }
 
+static int canSleep(void)
+{
+	Spitter *s;
+
+	s = (Spitter*)self->data;
+
+	return !s->enabled;
+}
+
 static void load(cJSON *root)
 {
 	Spitter *s;
@@ -160,8 +166,7 @@ static void fireBullet(void)
 	e->atlasImage = bulletTexture;
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
-	e->touch = bulletTouch;
-	e->die = bulletDie;
+	e->ops = &bulletOps;
 
 	/* center horizontally */
 	e->y += (self->w / 2) - (e->h / 2);
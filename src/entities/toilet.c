@@ -20,8 +20,11 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "toilet.h"
 
+static void tick(void);
 static void erupt(void);
 static void idle(void);
+static void stink(void);
+static void plunging(void);
 static void escape(void);
 static void touch(Entity *other);
 static void load(cJSON *root);
@@ -32,15 +35,17 @@ static AtlasImage *eruptFrames[2];
 static AtlasImage *escapeFrames[5];
 static AtlasImage *stinkFrames[2];
 static AtlasImage *plungingFrames[2];
+static EntityOps ops = {tick, touch, NULL, NULL, NULL, load, save};
+
+/* used to remove the player without death effects, once they've escaped */
+static EntityOps escapedOps;
 
 void initToilet(Entity *e)
 {
-	Toilet *t;
 	char filename[MAX_FILENAME_LENGTH];
 	int i;
 
-	t = malloc(sizeof(Toilet));
-	memset(t, 0, sizeof(Toilet));
+	allocEntityData(e, ED_TOILET);
 
 	for (i = 0 ; i < 5 ; i++)
 	{
@@ -62,27 +67,54 @@ void initToilet(Entity *e)
 
 	e->typeName = "toilet";
 	e->type = ET_TOILET;
-	e->data = t;
 	e->atlasImage = idleTexture;
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
 	e->flags = EF_NO_ENT_CLIP+EF_STATIC;
-	e->tick = idle;
-	e->touch = touch;
+	e->ops = &ops;
+}
+
+static void tick(void)
+{
+	Toilet *t;
+
+	t = (Toilet*)self->data;
+
+	switch (t->state)
+	{
+		case TS_STINK:
+			stink();
+			break;
+
+		case TS_ERUPT:
+			erupt();
+			break;
+
+		case TS_ESCAPE:
+			escape();
+			break;
 
-	e->load = load;
-	e->save = save;
+		case TS_PLUNGING:
+			plunging();
+			break;
+
+		default:
+			idle();
+			break;
+	}
 }
 
 static void idle(void)
 {
+	Toilet *t;
+
+	t = (Toilet*)self->data;
+
 	if (stage.time / 60 == 0)
 	{
 		self->atlasImage = eruptFrames[0];
 
-		self->tick = erupt;
-
-		self->touch = NULL;
+		t->state = TS_ERUPT;
 
 		game.stats[STAT_FAILS]++;
 	}
@@ -129,11 +161,9 @@ static void plunging(void)
 
 	if (--t->requiresPlunger <= 0)
 	{
-		self->tick = idle;
+		t->state = TS_IDLE;
 
 		self->atlasImage = idleTexture;
-
-		self->touch = touch;
 	}
 
 	idle();
@@ -186,17 +216,17 @@ static void touch(Entity *other)
 	Toilet *t;
 	Walter *w;
 
-	if (other != NULL)
-	{
-		t = (Toilet*)self->data;
+	t = (Toilet*)self->data;
 
+	if (other != NULL && t->state != TS_ERUPT && t->state != TS_PLUNGING)
+	{
 		if (!t->requiresPlunger)
 		{
 			if (other->type == ET_PLAYER)
 			{
 				addToiletSplashParticles(self->x + self->atlasImage->rect.w / 2, self->y + self->atlasImage->rect.h / 2);
 
-				self->tick = escape;
+				t->state = TS_ESCAPE;
 
 				self->atlasImage = escapeFrames[0];
 
@@ -205,7 +235,7 @@ static void touch(Entity *other)
 				other->health = 0;
 
 				/* just remove player */
-				other->die = NULL;
+				other->ops = &escapedOps;
 
 				stage.status = SS_COMPLETE;
 
@@ -226,9 +256,7 @@ static void touch(Entity *other)
 			{
 				w->equipment = EQ_NONE;
 
-				self->tick = plunging;
-
-				self->touch = NULL;
+				t->state = TS_PLUNGING;
 			}
 			else
 			{
@@ -252,7 +280,7 @@ static void load(cJSON *root)
 
 		self->atlasImage = stinkFrames[0];
 
-		self->tick = stink;
+		t->state = TS_STINK;
 	}
 }
 
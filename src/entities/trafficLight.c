@@ -28,30 +28,24 @@ static void save(cJSON *root);
 
 static AtlasImage *goTexture;
 static AtlasImage *stopTexture;
+static EntityOps ops = {tick, touch, NULL, NULL, NULL, load, save};
 
 void initTrafficLight(Entity *e)
 {
-	TrafficLight *t;
 
 	goTexture = getAtlasImage("gfx/entities/trafficLightGo.png", 1);
 	stopTexture = getAtlasImage("gfx/entities/trafficLightStop.png", 1);
 
-	t = malloc(sizeof(TrafficLight));
-	memset(t, 0, sizeof(TrafficLight));
+	allocEntityData(e, ED_TRAFFIC_LIGHT);
 
 	e->typeName = "trafficLight";
 	e->type = ET_SWITCH;
-	e->data = t;
 	e->atlasImage = stopTexture;
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
-	e->tick = tick;
-	e->touch = touch;
+	e->ops = &ops;
 	e->flags = EF_NO_ENT_CLIP+EF_STATIC;
 
-	e->load = load;
-	e->save = save;
-
 	e->light.a = 48;
 	e->light.foreground = 1;
 }
@@ -104,7 +98,7 @@ static void toggle(void)
 
 	t->on = !t->on;
 
-	activeEntities(t->targetName, t->on);
+	activeEntities(t->wire, t->on);
 
 	if (t->on)
 	{
@@ -127,6 +121,8 @@ static void load(cJSON *root)
 	t->on = cJSON_GetObjectItem(root, "on")->valueint;
 	STRNCPY(t->targetName, cJSON_GetObjectItem(root, "targetName")->valuestring, MAX_NAME_LENGTH);
 
+	t->wire = getWire(t->targetName);
+
 	if (t->on)
 	{
 		self->atlasImage = goTexture;
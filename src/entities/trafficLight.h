@@ -21,8 +21,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "../common.h"
 #include "../json/cJSON.h"
 
-extern void activeEntities(char *targetName, int activate);
+extern void activeEntities(Wire *wire, int active);
+extern void *allocEntityData(Entity *e, int dataType);
 extern AtlasImage *getAtlasImage(char *filename, int required);
+extern Wire *getWire(char *name);
 extern int isValidCloneFrame(Walter *w);
 extern void playPositionalSound(int snd, int ch, int srcX, int srcY, int destX, int destY);
 
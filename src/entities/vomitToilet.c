@@ -23,13 +23,11 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 static void tick(void);
 
 static AtlasImage *vomitFrames[2];
+static EntityOps ops = {tick, NULL, NULL, NULL, NULL, NULL, NULL};
 
 void initVomitToilet(Entity *e)
 {
-	Toilet *t;
-
-	t = malloc(sizeof(Toilet));
-	memset(t, 0, sizeof(Toilet));
+	allocEntityData(e, ED_TOILET);
 
 	vomitFrames[0] = getAtlasImage("gfx/entities/vomitToilet1.png", 1);
 	vomitFrames[1] = getAtlasImage("gfx/entities/vomitToilet2.png", 1);
@@ -37,12 +35,11 @@ void initVomitToilet(Entity *e)
 	e->typeName = "vomitToilet";
 	e->facing = 1;
 	e->type = ET_VOMIT_TOILET;
-	e->data = t;
 	e->atlasImage = vomitFrames[0];
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
 	e->flags = EF_NO_ENT_CLIP+EF_STATIC;
-	e->tick = tick;
+	e->ops = &ops;
 }
 
 static void tick(void)
@@ -26,10 +26,10 @@ static void save(cJSON *root);
 static void touch(Entity *other);
 
 static AtlasImage *textures[WATER_LEVEL_MAX];
+static EntityOps ops = {tick, touch, NULL, NULL, NULL, load, save};
 
 void initWaterButton(Entity *e)
 {
-	WaterButton *w;
 	int i;
 	char filename[MAX_NAME_LENGTH];
 
@@ -40,21 +40,15 @@ void initWaterButton(Entity *e)
 		textures[i] = getAtlasImage(filename, 1);
 	}
 
-	w = malloc(sizeof(WaterButton));
-	memset(w, 0, sizeof(WaterButton));
+	allocEntityData(e, ED_WATER_BUTTON);
 
 	e->typeName = "waterButton";
 	e->type = ET_STRUCTURE;
-	e->data = w;
-	e->tick = tick;
-	e->touch = touch;
+	e->ops = &ops;
 	e->atlasImage = textures[0];
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
 	e->flags = EF_SOLID+EF_WEIGHTLESS+EF_STATIC;
-
-	e->load = load;
-	e->save = save;
 }
 
 static void tick(void)
@@ -82,7 +76,7 @@ static void tick(void)
 			{
 				w->inflated = 0;
 
-				activeEntities(w->targetName, 0);
+				activeEntities(w->wire, 0);
 			}
 		}
 	}
@@ -113,7 +107,7 @@ static void touch(Entity *other)
 			{
 				w->inflated = 1;
 
-				activeEntities(w->targetName, 1);
+				activeEntities(w->wire, 1);
 			}
 		}
 	}
@@ -128,6 +122,8 @@ static void load(cJSON *root)
 	w->emptyRate = cJSON_GetObjectItem(root, "emptyRate")->valueint;
 	self->facing = strcmp(cJSON_GetObjectItem(root, "facing")->valuestring, "left") == 0 ? 0 : 1;
 	STRNCPY(w->targetName, cJSON_GetObjectItem(root, "targetName")->valuestring, MAX_NAME_LENGTH);
+
+	w->wire = getWire(w->targetName);
 }
 
 static void save(cJSON *root)
@@ -23,8 +23,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #define WATER_LEVEL_MAX   6
 
-extern void activeEntities(char *targetName, int activate);
+extern void activeEntities(Wire *wire, int active);
+extern void *allocEntityData(Entity *e, int dataType);
 extern AtlasImage *getAtlasImage(char *filename, int required);
+extern Wire *getWire(char *name);
 extern void playPositionalSound(int snd, int ch, int srcX, int srcY, int destX, int destY);
 
 extern Entity *self;
@@ -24,25 +24,23 @@ static void tick(void);
 static void touch(Entity *other);
 static void die(void);
 
+static EntityOps ops = {tick, touch, NULL, die, NULL, NULL, NULL};
+
 void initWaterPistol(Entity *e)
 {
 	Collectable *p;
 
-	p = malloc(sizeof(Collectable));
-	memset(p, 0, sizeof(Collectable));
+	p = allocEntityData(e, ED_COLLECTABLE);
 
 	p->bobValue = rand() % 10;
 
 	e->typeName = "waterPistol";
 	e->type = ET_ITEM;
-	e->data = p;
 	e->atlasImage = getAtlasImage("gfx/entities/waterPistol.png", 1);
 	e->w = e->atlasImage->rect.w;
 	e->h = e->atlasImage->rect.h;
 	e->flags = EF_WEIGHTLESS+EF_NO_ENT_CLIP+EF_STATIC;
-	e->tick = tick;
-	e->touch = touch;
-	e->die = die;
+	e->ops = &ops;
 
 	e->light.g = 255;
 	e->light.a = 64;
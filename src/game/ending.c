@@ -28,11 +28,11 @@ static void returnFromCredits(void);
 
 static AtlasImage *darknessTexture;
 static int timeout;
+static EntityOps playerOps;
 
 void initEnding(void)
 {
 	stage.entityTail = &stage.entityHead;
-	stage.particleTail = &stage.particleHead;
 	stage.cloneDataTail = &stage.cloneDataHead;
 
 	stage.num = 0;
@@ -40,7 +40,9 @@ void initEnding(void)
 	loadStage(0);
 
 	/* prevent player control */
-	stage.player->tick = NULL;
+	playerOps = *stage.player->ops;
+	playerOps.tick = NULL;
+	stage.player->ops = &playerOps;
 
 	initWipe(WIPE_FADE);
 
@@ -69,18 +71,14 @@ static void logic(void)
 
 static void draw(void)
 {
-	app.dev.drawing = 0;
-
 	focusOnVomit();
 
-	drawEntities(1);
+	drawEntities();
 
 	drawMap();
 
 	drawDarkness();
 
-	drawEntities(0);
-
 	if (timeout > 0)
 	{
 		drawText(SCREEN_WIDTH / 2, 50, 32, TEXT_CENTER, app.colors.white, "Well, that answers the question of whether Walter was hallucinating.");
@@ -101,7 +99,12 @@ static void drawDarkness(void)
 
 	dest.y += 150;
 
-	SDL_RenderCopyEx(app.renderer, darknessTexture->texture, &darknessTexture->rect, &dest, 0, NULL, SDL_FLIP_NONE);
+	/* over the map, but under Walter */
+	setDrawLayer(LAYER_MAP);
+
+	batchQuad(darknessTexture->texture, &darknessTexture->rect, &dest, SDL_FLIP_NONE, app.colors.white);
+
+	setDrawLayer(LAYER_OVERLAY);
 }
 
 static void focusOnVomit(void)
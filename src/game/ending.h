@@ -20,10 +20,11 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "../common.h"
 
+extern void batchQuad(SDL_Texture *texture, SDL_Rect *src, SDL_Rect *dest, SDL_RendererFlip flip, SDL_Color color);
 extern void destroyStage(void);
 extern void doEntities(void);
 extern int doWipe(void);
-extern void drawEntities(int background);
+extern void drawEntities(void);
 extern void drawMap(void);
 extern void drawText(int x, int y, int size, int align, SDL_Color color, const char *format, ...);
 extern void drawWipe(void);
@@ -32,6 +33,7 @@ extern void initCredits(void (*done)(void));
 extern void initTitle(void);
 extern void initWipe(int type);
 extern void loadStage(int randomTiles);
+extern void setDrawLayer(int layer);
 
 extern App app;
 extern Stage stage;
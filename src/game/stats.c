@@ -96,25 +96,14 @@ static void draw(void)
 
 static void drawArrows(void)
 {
-	SDL_SetTextureColorMod(arrow->texture, 64, 64, 64);
+	SDL_Color dim;
 
-	if (start > 0)
-	{
-		SDL_SetTextureColorMod(arrow->texture, 255, 255, 255);
-	}
-
-	blitAtlasImage(arrow, (SCREEN_WIDTH / 2) - 25, 490, 1, SDL_FLIP_NONE);
-
-	SDL_SetTextureColorMod(arrow->texture, 64, 64, 64);
-
-	if (start < STAT_TIME - 1)
-	{
-		SDL_SetTextureColorMod(arrow->texture, 255, 255, 255);
-	}
+	dim.r = dim.g = dim.b = 64;
+	dim.a = 255;
 
-	blitAtlasImage(arrow, (SCREEN_WIDTH / 2) + 25, 490, 1, SDL_FLIP_VERTICAL);
+	blitAtlasImageColor(arrow, (SCREEN_WIDTH / 2) - 25, 490, 1, SDL_FLIP_NONE, start > 0 ? app.colors.white : dim);
 
-	SDL_SetTextureColorMod(arrow->texture, 255, 255, 255);
+	blitAtlasImageColor(arrow, (SCREEN_WIDTH / 2) + 25, 490, 1, SDL_FLIP_VERTICAL, start < STAT_TIME - 1 ? app.colors.white : dim);
 }
 
 static void drawStats(void)
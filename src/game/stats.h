@@ -22,7 +22,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #define NUM_VISIBLE_STATS  7
 
-extern void blitAtlasImage(AtlasImage *atlasImage, int x, int y, int center, SDL_RendererFlip flip);
+extern void blitAtlasImageColor(AtlasImage *atlasImage, int x, int y, int center, SDL_RendererFlip flip, SDL_Color color);
 extern void calculateWidgetFrame(const char *groupName);
 extern void doWidgets(const char *groupName);
 extern void drawOutlineRect(int x, int y, int w, int h, int r, int g, int b, int a);
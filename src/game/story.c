@@ -51,14 +51,10 @@ static void logic(void)
 
 static void draw(void)
 {
-	app.dev.drawing = 0;
-
-	drawEntities(1);
+	drawEntities();
 
 	drawMap();
 
-	drawEntities(0);
-
 	drawRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, 0, 0, 0, 192);
 
 	app.text.wrap = SCREEN_WIDTH - 200;
@@ -23,7 +23,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 extern void calculateWidgetFrame(const char *groupName);
 extern const char *getFileLocation(const char *filename);
 extern void doWidgets(const char *groupName);
-extern void drawEntities(int background);
+extern void drawEntities(void);
 extern void drawMap(void);
 extern void drawRect(int x, int y, int w, int h, int r, int g, int b, int a);
 extern void drawText(int x, int y, int size, int align, SDL_Color color, const char *format, ...);
@@ -39,6 +39,7 @@ static Widget *storyWidget;
 static Widget *creditsWidget;
 static Widget *quitWidget;
 static Widget *previousWidget;
+static EntityOps playerOps;
 
 void initTitle(void)
 {
@@ -69,6 +70,8 @@ void initTitle(void)
 
 	app.selectedWidget = startWidget;
 
+	pauseRendering();
+
 	memset(&stage, 0, sizeof(Stage));
 	stage.entityTail = &stage.entityHead;
 
@@ -76,7 +79,9 @@ void initTitle(void)
 
 	stage.player->atlasImage = getAtlasImage("gfx/entities/guyPlunger.png", 1);
 
-	stage.player->tick = NULL;
+	playerOps = *stage.player->ops;
+	playerOps.tick = NULL;
+	stage.player->ops = &playerOps;
 
 	previousWidget = NULL;
 
@@ -107,14 +112,10 @@ static void logic(void)
 
 static void draw(void)
 {
-	app.dev.drawing = 0;
-
-	drawEntities(1);
+	drawEntities();
 
 	drawMap();
 
-	drawEntities(0);
-
 	drawRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, 0, 0, 0, 96);
 
 	if (previousWidget == NULL)
@@ -195,7 +196,14 @@ static void credits(void)
 	previousWidget = creditsWidget;
 }
 
+/* the main thread does the quitting, as it may be drawing while this runs */
 static void quit(void)
 {
-	exit(0);
+	SDL_Event event;
+
+	memset(&event, 0, sizeof(SDL_Event));
+
+	event.type = SDL_QUIT;
+
+	SDL_PushEvent(&event);
 }
@@ -25,7 +25,7 @@ extern void calculateWidgetFrame(const char *groupName);
 extern void doEntities(void);
 extern void doWidgets(const char *groupName);
 extern int doWipe(void);
-extern void drawEntities(int background);
+extern void drawEntities(void);
 extern void drawMap(void);
 extern void drawRect(int x, int y, int w, int h, int r, int g, int b, int a);
 extern void drawText(int x, int y, int size, int align, SDL_Color color, const char *format, ...);
@@ -42,6 +42,7 @@ extern void initStory(void (*done)(void));
 extern void initWipe(int type);
 extern void loadMusic(char *filename);
 extern void loadStage(int randomTiles);
+extern void pauseRendering(void);
 extern void playMusic(int loop);
 extern void randomizeTiles(void);
 extern void saveGame(void);
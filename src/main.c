@@ -21,17 +21,32 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "main.h"
 
 static void handleCommandLine(int argc, char *argv[]);
-static void capFrameRate(long *then, float *remainder);
+static int handleStartupCommandLine(int argc, char *argv[]);
+static void doLogicSteps(Uint64 *previous, Uint64 *accumulator);
+static void waitForLogicStep(Uint64 previous, Uint64 accumulator);
+static void waitUntil(Uint64 target);
+static void runPipelined(void);
+static int doLogic(void *data);
+static void stopLogic(void);
+
+static SDL_Thread *logicThread;
+static SDL_atomic_t logicRunning;
+static Uint64 logicStep;
 
 int main(int argc, char *argv[])
 {
-	long then, nextSecond;
-	float remainder;
+	Uint64 previous, accumulator;
+	long nextSecond;
 	int frames;
 
 	memset(&app, 0, sizeof(App));
 	app.texturesTail = &app.texturesHead;
 
+	if (handleStartupCommandLine(argc, argv))
+	{
+		return 0;
+	}
+
 	initSDL();
 
 	atexit(cleanup);
@@ -40,9 +55,21 @@ int main(int argc, char *argv[])
 
 	handleCommandLine(argc, argv);
 
-	then = SDL_GetTicks();
+	logicStep = SDL_GetPerformanceFrequency() / FPS;
+
+	if (app.dev.threaded)
+	{
+		/* the logic thread only hands over finished frames, so there is no previous state to blend with */
+		app.dev.interpolate = 0;
+
+		runPipelined();
+	}
+
+	previous = SDL_GetPerformanceCounter();
+
+	accumulator = logicStep;
 
-	frames = remainder = 0;
+	frames = 0;
 
 	nextSecond = SDL_GetTicks() + 1000;
 
@@ -52,7 +79,12 @@ int main(int argc, char *argv[])
 
 		doInput();
 
-		app.delegate.logic();
+		doLogicSteps(&previous, &accumulator);
+
+		if (app.dev.interpolate)
+		{
+			app.dev.blend = (float) accumulator / logicStep;
+		}
 
 		app.delegate.draw();
 
@@ -60,7 +92,11 @@ int main(int argc, char *argv[])
 
 		frames++;
 
-		capFrameRate(&then, &remainder);
+		/* when interpolating, vsync paces the drawing and logic runs whenever a step is due */
+		if (!app.dev.interpolate)
+		{
+			waitForLogicStep(previous, accumulator);
+		}
 
 		if (SDL_GetTicks() > nextSecond)
 		{
@@ -103,6 +139,11 @@ static void handleCommandLine(int argc, char *argv[])
 			stage.num = -1;
 		}
 
+		if (strcmp(argv[i], "-threaded") == 0)
+		{
+			app.dev.threaded = 1;
+		}
+
 		if (strcmp(argv[i], "-debug") == 0)
 		{
 			app.dev.debug = 1;
@@ -119,26 +160,209 @@ static void handleCommandLine(int argc, char *argv[])
 	}
 }
 
-static void capFrameRate(long *then, float *remainder)
+/* options needed before anything is loaded. -headless <stage> [-frames <n>] [-benchmark] runs the stage simulation without video or audio. -interpolate draws as often as the display refreshes, blending between logic steps */
+static int handleStartupCommandLine(int argc, char *argv[])
+{
+	int i, stageNum, frames, benchmark;
+
+	stageNum = benchmark = 0;
+
+	frames = HEADLESS_FRAMES;
+
+	for (i = 1 ; i < argc ; i++)
+	{
+		if (strcmp(argv[i], "-headless") == 0 && i + 1 < argc)
+		{
+			app.dev.headless = 1;
+
+			stageNum = atoi(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "-frames") == 0 && i + 1 < argc)
+		{
+			frames = atoi(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "-broadphase") == 0 && i + 1 < argc)
+		{
+			app.dev.broadphase = getBroadphaseType(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "-benchmark") == 0)
+		{
+			benchmark = 1;
+		}
+		else if (strcmp(argv[i], "-interpolate") == 0)
+		{
+			app.dev.interpolate = 1;
+		}
+
+		if (strcmp(argv[i], "-debug") == 0)
+		{
+			SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_DEBUG);
+		}
+	}
+
+	if (app.dev.headless)
+	{
+		initHeadless();
+
+		runHeadless(stageNum, frames, benchmark);
+	}
+
+	return app.dev.headless;
+}
+
+/* logic runs in fixed steps of 1/FPS, timed with the performance counter. A slow frame is made up with extra steps, up to a limit, after which the time is dropped rather than letting the game fall further behind */
+static void doLogicSteps(Uint64 *previous, Uint64 *accumulator)
+{
+	Uint64 now;
+	int steps;
+
+	now = SDL_GetPerformanceCounter();
+
+	*accumulator += now - *previous;
+
+	*previous = now;
+
+	for (steps = 0 ; *accumulator >= logicStep && steps < MAX_LOGIC_STEPS ; steps++)
+	{
+		if (app.dev.interpolate)
+		{
+			storeInterpolationState();
+		}
+
+		if (app.dev.threaded)
+		{
+			acquireInput();
+		}
+
+		app.delegate.logic();
+
+		*accumulator -= logicStep;
+	}
+
+	*accumulator %= logicStep;
+}
+
+static void waitForLogicStep(Uint64 previous, Uint64 accumulator)
+{
+	waitUntil(previous + logicStep - accumulator);
+}
+
+/* SDL_Delay can oversleep by a millisecond or more, so it only covers the bulk of the wait and the last stretch is spun */
+static void waitUntil(Uint64 target)
+{
+	Uint64 now, frequency, ms;
+
+	frequency = SDL_GetPerformanceFrequency();
+
+	now = SDL_GetPerformanceCounter();
+
+	while (now < target)
+	{
+		ms = ((target - now) * 1000) / frequency;
+
+		if (ms > SPIN_WAIT_MS)
+		{
+			SDL_Delay(ms - SPIN_WAIT_MS);
+		}
+
+		now = SDL_GetPerformanceCounter();
+	}
+}
+
+/* the logic thread runs the game and makes each frame's draw commands, while this thread draws and presents the last one it finished */
+static void runPipelined(void)
 {
-	long wait, frameTime;
+	long nextSecond;
+	int frames;
+
+	SDL_AtomicSet(&logicRunning, 1);
+
+	logicThread = SDL_CreateThread(doLogic, "logic", NULL);
 
-	wait = 16 + *remainder;
+	if (logicThread == NULL)
+	{
+		SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_WARN, "Couldn't create logic thread: %s", SDL_GetError());
+
+		app.dev.threaded = 0;
 
-	*remainder -= (int)*remainder;
+		return;
+	}
 
-	frameTime = SDL_GetTicks() - *then;
+	atexit(stopLogic);
 
-	wait -= frameTime;
+	frames = 0;
+
+	nextSecond = SDL_GetTicks() + 1000;
 
-	if (wait < 1)
+	while (1)
 	{
-		wait = 1;
+		doInput();
+
+		if (acquireFrame())
+		{
+			prepareScene();
+
+			presentScene();
+
+			frames++;
+		}
+		else
+		{
+			SDL_Delay(1);
+		}
+
+		if (SDL_GetTicks() > nextSecond)
+		{
+			app.dev.fps = frames;
+
+			nextSecond = SDL_GetTicks() + 1000;
+
+			frames = 0;
+		}
 	}
+}
+
+static int doLogic(void *data)
+{
+	Uint64 previous, accumulator;
+	long nextSecond;
 
-	SDL_Delay(wait);
+	previous = SDL_GetPerformanceCounter();
+
+	accumulator = logicStep;
+
+	nextSecond = SDL_GetTicks() + 1000;
+
+	while (SDL_AtomicGet(&logicRunning))
+	{
+		doLogicSteps(&previous, &accumulator);
+
+		beginDrawing();
+
+		app.delegate.draw();
 
-	*remainder += 0.667;
+		endDrawing();
 
-	*then = SDL_GetTicks();
+		waitForLogicStep(previous, accumulator);
+
+		if (SDL_GetTicks() > nextSecond)
+		{
+			game.stats[STAT_TIME]++;
+
+			nextSecond = SDL_GetTicks() + 1000;
+		}
+	}
+
+	return 0;
+}
+
+/* lets the logic thread finish its frame before cleanup pulls everything out from under it. Not possible if it is the one exiting */
+static void stopLogic(void)
+{
+	if (SDL_ThreadID() != SDL_GetThreadID(logicThread))
+	{
+		SDL_AtomicSet(&logicRunning, 0);
+
+		SDL_WaitThread(logicThread, NULL);
+	}
 }
@@ -20,10 +20,20 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "common.h"
 
+#define HEADLESS_FRAMES   (FPS * 60)
+#define MAX_LOGIC_STEPS   4
+#define SPIN_WAIT_MS      2
+
+extern int acquireFrame(void);
+extern void acquireInput(void);
+extern void beginDrawing(void);
 extern void cleanup(void);
 extern void doInput(void);
+extern void endDrawing(void);
+extern int getBroadphaseType(const char *name);
 extern void initEnding(void);
 extern void initGame(void);
+extern void initHeadless(void);
 extern void initSDL(void);
 extern void initStage(void);
 extern void initTitle(void);
@@ -32,6 +42,8 @@ extern void loadRandomStageMusic(void);
 extern void loadStage(int randomTiles);
 extern void prepareScene(void);
 extern void presentScene(void);
+extern void runHeadless(int stageNum, int frames, int benchmark);
+extern void storeInterpolationState(void);
 
 App app;
 Entity *player;
@@ -20,9 +20,11 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 typedef struct Texture Texture;
 typedef struct Entity Entity;
+typedef struct PoolBlock PoolBlock;
 typedef struct Quadtree Quadtree;
+typedef struct CandidateBlock CandidateBlock;
 typedef struct InitFunc InitFunc;
-typedef struct Particle Particle;
+typedef struct Wire Wire;
 typedef struct CloneData CloneData;
 typedef struct cJSON cJSON;
 typedef struct StageMeta StageMeta;
@@ -56,44 +58,82 @@ struct AtlasImage {
 	AtlasImage *next;
 };
 
+typedef struct {
+	void (*tick)(void);
+	void (*touch)(Entity *other);
+	void (*activate)(int active);
+	void (*die)(void);
+	int (*canSleep)(void);
+	void (*load)(cJSON *root);
+	void (*save)(cJSON *root);
+} EntityOps;
+
 struct Entity {
-	unsigned long id;
-	unsigned int type;
-	char *typeName;
-	char name[MAX_NAME_LENGTH];
 	float x;
 	float y;
+	float prevX;
+	float prevY;
 	int w;
 	int h;
-	int facing;
 	float dx;
 	float dy;
-	int health;
+	long flags;
 	int isOnGround;
+	int health;
+	struct {
+		int asleep;
+		int idle;
+		float x, y;
+	} sleep;
+	Entity *riding;
+	struct {
+		Entity *head;
+		Entity *next;
+		unsigned long frame;
+	} riders;
+	unsigned long movedFrame;
+	Entity *next;
+	EntityOps *ops;
+	struct {
+		int index;
+		int x, y, w, h;
+		int x1, y1, x2, y2;
+		int node;
+		int slot;
+	} broadphase;
+	unsigned long id;
+	unsigned int type;
+	char *typeName;
+	int facing;
 	int background;
 	void (*data);
+	int dataType;
 	AtlasImage *atlasImage;
 	struct {
 		int x, y;
 		int r, g, b, a;
 		int foreground;
 	} light;
-	void (*init)(void);
-	void (*tick)(void);
-	void (*touch)(Entity *other);
-	void (*activate)(int active);
-	void (*die)(void);
-	void (*load)(cJSON *root);
-	void (*save)(cJSON *root);
-	long flags;
-	Entity *riding;
-	Entity *next;
+	char name[MAX_NAME_LENGTH];
+};
+
+struct PoolBlock {
+	char *items;
+	PoolBlock *next;
 };
 
+typedef struct {
+	int itemSize;
+	int blockSize;
+	PoolBlock *blocks;
+	void *freeItems;
+} Pool;
+
 typedef struct {
 	int animTimer;
 	int requiresPlunger;
 	int frameNum;
+	int state;
 } Toilet;
 
 typedef struct {
@@ -139,11 +179,13 @@ typedef struct {
 typedef struct {
 	int on;
 	char targetName[MAX_NAME_LENGTH];
+	Wire *wire;
 } TrafficLight;
 
 typedef struct {
 	int weight;
 	char targetName[MAX_NAME_LENGTH];
+	Wire *wire;
 } PressurePlate;
 
 typedef struct {
@@ -152,8 +194,17 @@ typedef struct {
 	int emptyRate;
 	int emptyTimer;
 	char targetName[MAX_NAME_LENGTH];
+	Wire *wire;
 } WaterButton;
 
+struct Wire {
+	char name[MAX_NAME_LENGTH];
+	Entity **targets;
+	int numTargets;
+	int capacity;
+	Wire *next;
+};
+
 struct CloneData {
 	int frame;
 	float dx;
@@ -170,35 +221,146 @@ typedef struct {
 	CloneData data;
 } Walter;
 
-struct Particle {
-	float x;
-	float y;
-	float dx;
-	float dy;
-	int life;
+/* kept in spawn order, so the oldest particles are always at the front */
+typedef struct {
+	float x[MAX_PARTICLES];
+	float y[MAX_PARTICLES];
+	float dx[MAX_PARTICLES];
+	float dy[MAX_PARTICLES];
+	float gravity[MAX_PARTICLES];
+	int life[MAX_PARTICLES];
+	SDL_Color color[MAX_PARTICLES];
+	int numParticles;
+} ParticlePool;
+
+typedef struct {
+	int x, y, w, h;
+	int ents;
+	int capacity;
+	int numEnts;
+	int addedTo;
+} QuadtreeNode;
+
+struct Quadtree {
+	QuadtreeNode *nodes;
+	int numNodes;
+	int firstLeaf;
+	Entity **slots;
+	int numSlots;
+	int slotCapacity;
+};
+
+typedef struct {
+	Entity **ents;
+	int capacity;
+	int numEnts;
+} GridCell;
+
+typedef struct {
+	GridCell cells[GRID_WIDTH][GRID_HEIGHT];
+} Grid;
+
+typedef struct {
+	int type;
+	Quadtree quadtree;
+	Grid grid;
+} Broadphase;
+
+typedef struct {
+	Entity **ents;
+	int numEnts;
+	int capacity;
+} EntityList;
+
+typedef struct {
+	SDL_Texture *texture;
+	int chunk;
+	unsigned long lastUsed;
+} MapChunk;
+
+typedef struct {
+	MapChunk chunks[MAP_CHUNK_SLOTS];
+	unsigned long frame;
+	void (*drawTile)(int mx, int my, int x, int y);
+	void (*drawSprites)(int x, int background);
+} ChunkCache;
+
+typedef struct {
 	AtlasImage *atlasImage;
+	int x, y;
+	int background;
+	SDL_RendererFlip flip;
+} MapSprite;
+
+typedef struct {
+	int type;
+	int layer;
+	SDL_Texture *texture;
+	SDL_Rect src;
+	SDL_Rect dest;
 	SDL_Color color;
-	int weightless;
-	Particle *next;
-};
+	SDL_RendererFlip flip;
+	int wholeTexture;
+	int text, size, align, wrap;
+	ChunkCache *chunks;
+} RenderCommand;
 
-struct Quadtree {
-	int depth;
-	int x, y, w, h;
+/* everything needed to draw one frame, so that it can be drawn while the next one is being made */
+typedef struct {
+	RenderCommand *commands;
+	int *order;
+	int numCommands;
+	int capacity;
+	char *text;
+	int textLength;
+	int textCapacity;
+} RenderList;
+
+typedef struct {
+	int keyboard[MAX_KEYBOARD_KEYS];
+	int joypadButton[SDL_CONTROLLER_BUTTON_MAX];
+	int joypadAxis[JOYPAD_AXIS_MAX];
+	int mouseButtons[MAX_MOUSE_BUTTONS];
+	int mouseX, mouseY;
+	int lastKeyPressed, lastButtonPressed;
+	unsigned long keyPresses, buttonPresses;
+	unsigned long wheelUp, wheelDown;
+} InputState;
+
+typedef struct {
+	SDL_Rect *glyph;
+	SDL_Rect dest;
+	int colored;
+	SDL_Color color;
+} TextGlyph;
+
+typedef struct {
+	char text[MAX_LINE_LENGTH];
+	unsigned long hash;
+	int size, align, wrap;
+	SDL_Color color;
+	SDL_Texture *texture;
+	int textureW, textureH;
+	SDL_Rect bounds;
+	unsigned long lastUsed;
+} CachedText;
+
+struct CandidateBlock {
 	Entity **ents;
 	int capacity;
 	int numEnts;
-	int addedTo;
-	Quadtree *node[4];
+	CandidateBlock *next;
 };
 
 typedef struct {
 	int num;
 	int map[MAP_WIDTH][MAP_HEIGHT];
+	Uint64 solidRows[MAP_HEIGHT][SOLID_ROW_WORDS];
+	Uint64 solidCols[MAP_WIDTH];
 	AtlasImage *tiles[MAX_TILES];
 	Entity entityHead, *entityTail;
 	Entity *player;
-	Particle particleHead, *particleTail;
+	ParticlePool particles;
 	unsigned int clones, cloneLimit;
 	unsigned int time, timeLimit;
 	int keys, totalKeys;
@@ -210,10 +372,14 @@ typedef struct {
 	int nextStageTimer;
 	char tips[MAX_TIPS][MAX_DESCRIPTION_LENGTH];
 	CloneData cloneDataHead, *cloneDataTail;
-	Quadtree quadtree;
+	Broadphase staticBroadphase;
+	Broadphase dynamicBroadphase;
+	Wire wireHead;
 	struct {
 		int x;
 		int y;
+		int prevX;
+		int prevY;
 		int minX;
 		int maxX;
 	} camera;
@@ -315,9 +481,20 @@ typedef struct {
 	} wipe;
 	struct {
 		int debug;
+		int headless;
+		int threaded;
+		int interpolate;
+		float blend;
+		int broadphase;
 		int fps;
 		int ents;
+		int sleeping;
 		int collisions;
 		int drawing;
+		int batches;
+		int textHits;
+		int textMisses;
+		int poolHits;
+		int poolMisses;
 	} dev;
 } App;
@@ -63,7 +63,13 @@ static void loadAtlasData(void)
 	char *text;
 	unsigned long i;
 
-	atlasTexture = loadTexture(getFileLocation("gfx/atlas/atlas.png"));
+	/* headless runs only need the image rects */
+	atlasTexture = NULL;
+
+	if (!app.dev.headless)
+	{
+		atlasTexture = loadTexture(getFileLocation("gfx/atlas/atlas.png"));
+	}
 
 	text = readFile(getFileLocation("data/atlas/atlas.json"));
 
@@ -25,3 +25,5 @@ extern const char *getFileLocation(const char *filename);
 extern SDL_Texture *loadTexture(const char *filename);
 extern unsigned long hashcode(const char *str);
 extern char *readFile(const char *filename);
+
+extern App app;
@@ -21,6 +21,33 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "draw.h"
 
 static void initColor(SDL_Color *c, int r, int g, int b);
+static void initBatch(void);
+static void drawDevOverlay(void);
+static RenderCommand *addCommand(int type);
+static void submitList(RenderList *list);
+static void renderRect(RenderCommand *c);
+void blitAtlasImageColor(AtlasImage *atlasImage, int x, int y, int center, SDL_RendererFlip flip, SDL_Color color);
+void batchQuad(SDL_Texture *texture, SDL_Rect *src, SDL_Rect *dest, SDL_RendererFlip flip, SDL_Color color);
+void renderQuad(SDL_Texture *texture, SDL_Rect *src, SDL_Rect *dest, SDL_RendererFlip flip, SDL_Color color);
+void flushQuads(void);
+
+static RenderList renderLists[NUM_RENDER_LISTS];
+static RenderList *recording;
+static int drawLayer;
+static int backList;
+static int frontList;
+static SDL_atomic_t readyList;
+static SDL_atomic_t rendering;
+static SDL_atomic_t renderPaused;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+static SDL_Vertex batchVertices[MAX_BATCH_QUADS * 4];
+static int batchIndices[MAX_BATCH_QUADS * 6];
+static int numBatchQuads;
+static SDL_Texture *batchTexture;
+static int batchTextureWidth;
+static int batchTextureHeight;
+#endif
 
 void initGraphics(void)
 {
@@ -37,10 +64,21 @@ void initGraphics(void)
 	initColor(&app.colors.darkGrey, 128, 128, 128);
 
 	app.backBuffer = SDL_CreateTexture(app.renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+	initBatch();
 }
 
 void prepareScene(void)
 {
+	app.dev.batches = 0;
+
+	if (!app.dev.threaded)
+	{
+		app.dev.drawing = 0;
+
+		drawLayer = LAYER_OVERLAY;
+	}
+
 	SDL_SetRenderTarget(app.renderer, app.backBuffer);
 	SDL_SetRenderDrawColor(app.renderer, 0, 0, 0, 255);
 	SDL_RenderClear(app.renderer);
@@ -48,9 +86,20 @@ void prepareScene(void)
 
 void presentScene(void)
 {
-	if (app.dev.debug)
+	if (app.dev.threaded)
+	{
+		submitList(&renderLists[frontList]);
+
+		SDL_AtomicSet(&rendering, 0);
+	}
+	else
 	{
-		drawText(SCREEN_WIDTH - 5, SCREEN_HEIGHT - 30, 32, TEXT_RIGHT, app.colors.white, "%dfps | Ents: %d | Cols: %d | Draw: %d", app.dev.fps, app.dev.ents, app.dev.collisions, app.dev.drawing);
+		if (app.dev.debug)
+		{
+			drawDevOverlay();
+		}
+
+		submitList(recording);
 	}
 
 	SDL_SetRenderTarget(app.renderer, NULL);
@@ -58,6 +107,68 @@ void presentScene(void)
 	SDL_RenderPresent(app.renderer);
 }
 
+static void drawDevOverlay(void)
+{
+	drawText(SCREEN_WIDTH - 5, SCREEN_HEIGHT - 30, 32, TEXT_RIGHT, app.colors.white, "%dfps | Ents: %d (%d active, %d asleep) | Cols: %d | Draw: %d (%d batches)", app.dev.fps, app.dev.ents, app.dev.ents - app.dev.sleeping, app.dev.sleeping, app.dev.collisions, app.dev.drawing, app.dev.batches);
+
+	drawText(SCREEN_WIDTH - 5, SCREEN_HEIGHT - 60, 32, TEXT_RIGHT, app.colors.white, "Pool: %d hits | %d misses | Text: %d hits | %d misses", app.dev.poolHits, app.dev.poolMisses, app.dev.textHits, app.dev.textMisses);
+}
+
+/* the logic thread makes each frame into the back list, and hands it over to the main thread when done */
+void beginDrawing(void)
+{
+	app.dev.drawing = 0;
+
+	drawLayer = LAYER_OVERLAY;
+}
+
+void endDrawing(void)
+{
+	if (app.dev.debug)
+	{
+		drawDevOverlay();
+	}
+
+	backList = SDL_AtomicSet(&readyList, backList | RENDER_LIST_FRESH) & ~RENDER_LIST_FRESH;
+
+	/* this will be a frame that was never drawn, if the main thread has fallen behind */
+	recording = &renderLists[backList];
+	recording->numCommands = recording->textLength = 0;
+
+	SDL_AtomicSet(&renderPaused, 0);
+}
+
+/* main thread. Takes the newest finished frame, if there is one. presentScene then draws it */
+int acquireFrame(void)
+{
+	SDL_AtomicSet(&rendering, 1);
+
+	if (!SDL_AtomicGet(&renderPaused) && SDL_AtomicGet(&readyList) & RENDER_LIST_FRESH)
+	{
+		frontList = SDL_AtomicSet(&readyList, frontList) & ~RENDER_LIST_FRESH;
+
+		return 1;
+	}
+
+	SDL_AtomicSet(&rendering, 0);
+
+	return 0;
+}
+
+/* logic thread. Must be called before changing anything that the main thread reads while drawing (the map, the map sprites, and the chunk caches). Drawing resumes with the next frame */
+void pauseRendering(void)
+{
+	if (app.dev.threaded)
+	{
+		SDL_AtomicSet(&renderPaused, 1);
+
+		while (SDL_AtomicGet(&rendering))
+		{
+			SDL_Delay(1);
+		}
+	}
+}
+
 void blit(SDL_Texture *texture, int x, int y, int center, SDL_RendererFlip flip)
 {
 	SDL_Rect dest;
@@ -72,10 +183,15 @@ void blit(SDL_Texture *texture, int x, int y, int center, SDL_RendererFlip flip)
 		dest.y -= dest.h / 2;
 	}
 
-	SDL_RenderCopyEx(app.renderer, texture, NULL, &dest, 0, NULL, flip);
+	batchQuad(texture, NULL, &dest, flip, app.colors.white);
 }
 
 void blitAtlasImage(AtlasImage *atlasImage, int x, int y, int center, SDL_RendererFlip flip)
+{
+	blitAtlasImageColor(atlasImage, x, y, center, flip, app.colors.white);
+}
+
+void blitAtlasImageColor(AtlasImage *atlasImage, int x, int y, int center, SDL_RendererFlip flip, SDL_Color color)
 {
 	SDL_Rect dest;
 
@@ -90,33 +206,325 @@ void blitAtlasImage(AtlasImage *atlasImage, int x, int y, int center, SDL_Render
 		dest.y -= (dest.h / 2);
 	}
 
-	SDL_RenderCopyEx(app.renderer, atlasImage->texture, &atlasImage->rect, &dest, 0, NULL, flip);
+	batchQuad(atlasImage->texture, &atlasImage->rect, &dest, flip, color);
+}
+
+/* a NULL src uses the whole texture. Nothing is drawn until the frame's commands are submitted, sorted by layer, by presentScene */
+void batchQuad(SDL_Texture *texture, SDL_Rect *src, SDL_Rect *dest, SDL_RendererFlip flip, SDL_Color color)
+{
+	RenderCommand *c;
+
+	c = addCommand(RC_QUAD);
+
+	c->texture = texture;
+	c->dest = *dest;
+	c->color = color;
+	c->flip = flip;
+	c->wholeTexture = src == NULL;
+
+	if (src != NULL)
+	{
+		c->src = *src;
+	}
+}
+
+void batchText(int x, int y, int size, int align, int wrap, SDL_Color color, const char *text)
+{
+	RenderCommand *c;
+	int len, n;
+
+	len = strlen(text) + 1;
+
+	if (recording->textLength + len > recording->textCapacity)
+	{
+		n = MAX(recording->textCapacity * 2, recording->textLength + len);
+
+		recording->text = resize(recording->text, recording->textCapacity, n);
+
+		recording->textCapacity = n;
+	}
+
+	c = addCommand(RC_TEXT);
+
+	c->dest.x = x;
+	c->dest.y = y;
+	c->size = size;
+	c->align = align;
+	c->wrap = wrap;
+	c->color = color;
+	c->text = recording->textLength;
+
+	memcpy(recording->text + recording->textLength, text, len);
+
+	recording->textLength += len;
+}
+
+void batchChunks(ChunkCache *cache, int camX, int camY)
+{
+	RenderCommand *c;
+
+	c = addCommand(RC_CHUNKS);
+
+	c->chunks = cache;
+	c->dest.x = camX;
+	c->dest.y = camY;
 }
 
 void drawRect(int x, int y, int w, int h, int r, int g, int b, int a)
 {
-	SDL_Rect rect;
-	rect.x = x;
-	rect.y = y;
-	rect.w = w;
-	rect.h = h;
+	RenderCommand *c;
+
+	c = addCommand(RC_RECT);
 
-	SDL_SetRenderDrawBlendMode(app.renderer, a < 255 ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
-	SDL_SetRenderDrawColor(app.renderer, r, g, b, a);
-	SDL_RenderFillRect(app.renderer, &rect);
+	c->dest.x = x;
+	c->dest.y = y;
+	c->dest.w = w;
+	c->dest.h = h;
+	c->color.r = r;
+	c->color.g = g;
+	c->color.b = b;
+	c->color.a = a;
 }
 
 void drawOutlineRect(int x, int y, int w, int h, int r, int g, int b, int a)
 {
-	SDL_Rect rect;
-	rect.x = x;
-	rect.y = y;
-	rect.w = w;
-	rect.h = h;
+	RenderCommand *c;
+
+	c = addCommand(RC_OUTLINE_RECT);
+
+	c->dest.x = x;
+	c->dest.y = y;
+	c->dest.w = w;
+	c->dest.h = h;
+	c->color.r = r;
+	c->color.g = g;
+	c->color.b = b;
+	c->color.a = a;
+}
+
+void setDrawLayer(int layer)
+{
+	drawLayer = layer;
+}
+
+static RenderCommand *addCommand(int type)
+{
+	RenderCommand *c;
+	int n;
+
+	if (recording->numCommands == recording->capacity)
+	{
+		n = recording->capacity * 2;
+
+		recording->commands = resize(recording->commands, sizeof(RenderCommand) * recording->capacity, sizeof(RenderCommand) * n);
+		recording->order = resize(recording->order, sizeof(int) * recording->capacity, sizeof(int) * n);
+
+		recording->capacity = n;
+	}
+
+	c = &recording->commands[recording->numCommands++];
+
+	c->type = type;
+	c->layer = drawLayer;
 
-	SDL_SetRenderDrawBlendMode(app.renderer, a < 255 ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
-	SDL_SetRenderDrawColor(app.renderer, r, g, b, a);
-	SDL_RenderDrawRect(app.renderer, &rect);
+	app.dev.drawing++;
+
+	return c;
+}
+
+/* a stable counting sort by layer. Within a layer the order is kept, as overlapping quads from different textures (such as map chunks and sprites) still need to be drawn in order */
+static void submitList(RenderList *list)
+{
+	RenderCommand *c;
+	int i, total, count[LAYER_MAX];
+
+	memset(count, 0, sizeof(count));
+
+	for (i = 0 ; i < list->numCommands ; i++)
+	{
+		count[list->commands[i].layer]++;
+	}
+
+	total = 0;
+
+	for (i = 0 ; i < LAYER_MAX ; i++)
+	{
+		total += count[i];
+
+		count[i] = total - count[i];
+	}
+
+	for (i = 0 ; i < list->numCommands ; i++)
+	{
+		list->order[count[list->commands[i].layer]++] = i;
+	}
+
+	for (i = 0 ; i < list->numCommands ; i++)
+	{
+		c = &list->commands[list->order[i]];
+
+		switch (c->type)
+		{
+			case RC_QUAD:
+				renderQuad(c->texture, c->wholeTexture ? NULL : &c->src, &c->dest, c->flip, c->color);
+				break;
+
+			case RC_RECT:
+			case RC_OUTLINE_RECT:
+				renderRect(c);
+				break;
+
+			case RC_TEXT:
+				renderText(list->text + c->text, c->dest.x, c->dest.y, c->size, c->align, c->wrap, c->color);
+				break;
+
+			case RC_CHUNKS:
+				renderChunks(c->chunks, c->dest.x, c->dest.y);
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	flushQuads();
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	/* a texture made after this could be given the same address as one that has since been destroyed */
+	batchTexture = NULL;
+#endif
+
+	list->numCommands = list->textLength = 0;
+}
+
+static void renderRect(RenderCommand *c)
+{
+	flushQuads();
+
+	SDL_SetRenderDrawBlendMode(app.renderer, c->color.a < 255 ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+	SDL_SetRenderDrawColor(app.renderer, c->color.r, c->color.g, c->color.b, c->color.a);
+
+	if (c->type == RC_RECT)
+	{
+		SDL_RenderFillRect(app.renderer, &c->dest);
+	}
+	else
+	{
+		SDL_RenderDrawRect(app.renderer, &c->dest);
+	}
+}
+
+/* draws straight away, for use while submitting. Quads are put together until the texture changes, as everything is drawn from a handful of textures (mostly the atlas) */
+void renderQuad(SDL_Texture *texture, SDL_Rect *src, SDL_Rect *dest, SDL_RendererFlip flip, SDL_Color color)
+{
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	SDL_Vertex *v;
+	float u1, v1, u2, v2, t;
+	int i;
+
+	if (texture != batchTexture || numBatchQuads == MAX_BATCH_QUADS)
+	{
+		flushQuads();
+
+		if (texture != batchTexture)
+		{
+			batchTexture = texture;
+
+			SDL_QueryTexture(texture, NULL, NULL, &batchTextureWidth, &batchTextureHeight);
+		}
+	}
+
+	if (src != NULL)
+	{
+		u1 = src->x / (float)batchTextureWidth;
+		v1 = src->y / (float)batchTextureHeight;
+		u2 = (src->x + src->w) / (float)batchTextureWidth;
+		v2 = (src->y + src->h) / (float)batchTextureHeight;
+	}
+	else
+	{
+		u1 = v1 = 0;
+		u2 = v2 = 1;
+	}
+
+	if (flip & SDL_FLIP_HORIZONTAL)
+	{
+		t = u1;
+		u1 = u2;
+		u2 = t;
+	}
+
+	if (flip & SDL_FLIP_VERTICAL)
+	{
+		t = v1;
+		v1 = v2;
+		v2 = t;
+	}
+
+	v = &batchVertices[numBatchQuads * 4];
+
+	v[0].position.x = v[3].position.x = dest->x;
+	v[1].position.x = v[2].position.x = dest->x + dest->w;
+	v[0].position.y = v[1].position.y = dest->y;
+	v[2].position.y = v[3].position.y = dest->y + dest->h;
+
+	v[0].tex_coord.x = v[3].tex_coord.x = u1;
+	v[1].tex_coord.x = v[2].tex_coord.x = u2;
+	v[0].tex_coord.y = v[1].tex_coord.y = v1;
+	v[2].tex_coord.y = v[3].tex_coord.y = v2;
+
+	for (i = 0 ; i < 4 ; i++)
+	{
+		v[i].color = color;
+	}
+
+	numBatchQuads++;
+#else
+	/* no geometry API, so draw straight away, tinting the texture for just this copy */
+	if (color.r != 255 || color.g != 255 || color.b != 255 || color.a != 255)
+	{
+		SDL_SetTextureColorMod(texture, color.r, color.g, color.b);
+		SDL_SetTextureAlphaMod(texture, color.a);
+
+		SDL_RenderCopyEx(app.renderer, texture, src, dest, 0, NULL, flip);
+
+		SDL_SetTextureColorMod(texture, 255, 255, 255);
+		SDL_SetTextureAlphaMod(texture, 255);
+	}
+	else
+	{
+		SDL_RenderCopyEx(app.renderer, texture, src, dest, 0, NULL, flip);
+	}
+
+	app.dev.batches++;
+#endif
+}
+
+void renderAtlasImage(AtlasImage *atlasImage, int x, int y, SDL_RendererFlip flip)
+{
+	SDL_Rect dest;
+
+	dest.x = x;
+	dest.y = y;
+	dest.w = atlasImage->rect.w;
+	dest.h = atlasImage->rect.h;
+
+	renderQuad(atlasImage->texture, &atlasImage->rect, &dest, flip, app.colors.white);
+}
+
+/* must be called before the renderer is used directly, or the render target changes */
+void flushQuads(void)
+{
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	if (numBatchQuads > 0)
+	{
+		SDL_RenderGeometry(app.renderer, batchTexture, batchVertices, numBatchQuads * 4, batchIndices, numBatchQuads * 6);
+
+		numBatchQuads = 0;
+
+		app.dev.batches++;
+	}
+#endif
 }
 
 static void initColor(SDL_Color *c, int r, int g, int b)
@@ -127,3 +535,42 @@ static void initColor(SDL_Color *c, int r, int g, int b)
 	c->b = b;
 	c->a = 255;
 }
+
+static void initBatch(void)
+{
+	int i;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	for (i = 0 ; i < MAX_BATCH_QUADS ; i++)
+	{
+		batchIndices[(i * 6) + 0] = (i * 4) + 0;
+		batchIndices[(i * 6) + 1] = (i * 4) + 1;
+		batchIndices[(i * 6) + 2] = (i * 4) + 2;
+		batchIndices[(i * 6) + 3] = (i * 4) + 2;
+		batchIndices[(i * 6) + 4] = (i * 4) + 3;
+		batchIndices[(i * 6) + 5] = (i * 4) + 0;
+	}
+
+	numBatchQuads = 0;
+	batchTexture = NULL;
+#endif
+
+	for (i = 0 ; i < NUM_RENDER_LISTS ; i++)
+	{
+		renderLists[i].capacity = RENDER_COMMANDS_INITIAL_CAPACITY;
+		renderLists[i].commands = malloc(sizeof(RenderCommand) * renderLists[i].capacity);
+		renderLists[i].order = malloc(sizeof(int) * renderLists[i].capacity);
+
+		renderLists[i].textCapacity = RENDER_TEXT_INITIAL_CAPACITY;
+		renderLists[i].text = malloc(renderLists[i].textCapacity);
+	}
+
+	backList = 0;
+	frontList = 2;
+
+	SDL_AtomicSet(&readyList, 1);
+
+	recording = &renderLists[backList];
+
+	drawLayer = LAYER_OVERLAY;
+}
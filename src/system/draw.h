@@ -22,6 +22,18 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "../common.h"
 
+#define MAX_BATCH_QUADS   512
+
+#define RENDER_COMMANDS_INITIAL_CAPACITY   1024
+#define RENDER_TEXT_INITIAL_CAPACITY       4096
+
+/* one list being made, one ready to draw, and one being drawn */
+#define NUM_RENDER_LISTS   3
+#define RENDER_LIST_FRESH  4
+
 extern void drawText(int x, int y, int size, int align, SDL_Color color, const char *format, ...);
+extern void renderChunks(ChunkCache *cache, int camX, int camY);
+extern void renderText(const char *text, int x, int y, int size, int align, int wrap, SDL_Color color);
+extern void *resize(void *array, int oldSize, int newSize);
 
 extern App app;
@@ -0,0 +1,110 @@
+/*
+Copyright (C) 2019 Parallel Realities
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "headless.h"
+
+static void runSimulation(int stageNum, int frames);
+static unsigned long getStateChecksum(void);
+
+/* a benchmark runs the same simulation once with each broadphase */
+void runHeadless(int stageNum, int frames, int benchmark)
+{
+	int i;
+
+	if (benchmark)
+	{
+		for (i = 0 ; i < BP_MAX ; i++)
+		{
+			app.dev.broadphase = i;
+
+			runSimulation(stageNum, frames);
+		}
+	}
+	else
+	{
+		runSimulation(stageNum, frames);
+	}
+}
+
+static void runSimulation(int stageNum, int frames)
+{
+	Uint64 start, elapsed;
+	double seconds;
+	long collisions;
+	int i;
+
+	app.dev.poolHits = app.dev.poolMisses = 0;
+
+	initStageSimulation(stageNum);
+
+	collisions = 0;
+
+	start = SDL_GetPerformanceCounter();
+
+	for (i = 0 ; i < frames ; i++)
+	{
+		doStageSimulation();
+
+		collisions += app.dev.collisions;
+	}
+
+	elapsed = SDL_GetPerformanceCounter() - start;
+
+	seconds = elapsed;
+	seconds /= SDL_GetPerformanceFrequency();
+
+	printf("Stage %03d [%s]: %d frames in %.3fs", stageNum, getBroadphaseName(stage.dynamicBroadphase.type), frames, seconds);
+
+	if (seconds > 0)
+	{
+		printf(" (%.0f frames/s, %.2fus/frame)", frames / seconds, (seconds * 1000000) / MAX(frames, 1));
+	}
+
+	printf("\n");
+
+	printf("Ents: %d | Cols: %ld | Status: %d | State: %08lx\n", app.dev.ents, collisions, stage.status, getStateChecksum());
+
+	printf("Active: %d | Asleep: %d\n", app.dev.ents - app.dev.sleeping, app.dev.sleeping);
+
+	printf("Pool: %d hits | %d misses\n", app.dev.poolHits, app.dev.poolMisses);
+
+	destroyStage();
+}
+
+/* order independent, so the same simulation always reports the same value */
+static unsigned long getStateChecksum(void)
+{
+	Entity *e;
+	unsigned long checksum, h;
+
+	checksum = 0;
+
+	for (e = stage.entityHead.next ; e != NULL ; e = e->next)
+	{
+		/* via long, as a negative float converted straight to unsigned is undefined and differs between compilers */
+		h = (unsigned long)(long)(e->x * 100) * 31 + (unsigned long)(long)(e->y * 100);
+		h = (h * 31) + e->type;
+		h = (h * 31) + e->health;
+
+		checksum += h * 2654435761UL;
+	}
+
+	return checksum & 0xFFFFFFFF;
+}
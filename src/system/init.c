@@ -46,6 +46,11 @@ void initSDL(void)
 
 	loadConfig();
 
+	if (app.dev.interpolate)
+	{
+		rendererFlags |= SDL_RENDERER_PRESENTVSYNC;
+	}
+
 	if (app.config.fullscreen)
 	{
 		windowFlags |= SDL_WINDOW_FULLSCREEN;
@@ -122,6 +127,24 @@ void initGame(void)
 	}
 }
 
+/* only the pieces needed to load and simulate a stage - no window, renderer, fonts or mixer */
+void initHeadless(void)
+{
+	if (SDL_Init(0) < 0)
+	{
+		printf("Couldn't initialize SDL: %s\n", SDL_GetError());
+		exit(1);
+	}
+
+	initLookups();
+
+	initAtlas();
+
+	initEntityFactory();
+
+	initParticles();
+}
+
 static void showLoadingStep(float step, float maxSteps)
 {
 	SDL_Rect r;
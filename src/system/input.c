@@ -31,6 +31,17 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define JOYPAD_BUTTON_MAX 64
 #endif
 
+/* Input as the event handlers see it. It reaches app through applyInput, directly or via the logic thread */
+static InputState liveInput;
+static InputState appliedInput;
+static InputState inputStates[NUM_INPUT_STATES];
+static int writeInput = 1;
+static int readInput = 2;
+static SDL_atomic_t readyInput;
+
+static void applyInput(InputState *input);
+static void publishInput(void);
+
 /* Rising-edge tracking for joystick buttons */
 static unsigned char s_prevJoypadButton[JOYPAD_BUTTON_MAX];
 static unsigned char s_edgeJoypadButton[JOYPAD_BUTTON_MAX];
@@ -57,7 +68,7 @@ void doKeyUp(SDL_KeyboardEvent* event)
 {
     if (event->repeat == 0 && event->keysym.scancode < MAX_KEYBOARD_KEYS)
     {
-        app.keyboard[event->keysym.scancode] = 0;
+        liveInput.keyboard[event->keysym.scancode] = 0;
     }
 }
 
@@ -65,8 +76,9 @@ void doKeyDown(SDL_KeyboardEvent* event)
 {
     if (event->repeat == 0 && event->keysym.scancode < MAX_KEYBOARD_KEYS)
     {
-        app.keyboard[event->keysym.scancode] = 1;
-        app.lastKeyPressed = event->keysym.scancode;
+        liveInput.keyboard[event->keysym.scancode] = 1;
+        liveInput.lastKeyPressed = event->keysym.scancode;
+        liveInput.keyPresses++;
     }
 }
 
@@ -74,7 +86,7 @@ static void doMouseDown(SDL_MouseButtonEvent* event)
 {
     if (event->button >= 0 && event->button < MAX_MOUSE_BUTTONS)
     {
-        app.mouse.buttons[event->button] = 1;
+        liveInput.mouseButtons[event->button] = 1;
     }
 }
 
@@ -82,7 +94,7 @@ static void doMouseUp(SDL_MouseButtonEvent* event)
 {
     if (event->button >= 0 && event->button < MAX_MOUSE_BUTTONS)
     {
-        app.mouse.buttons[event->button] = 0;
+        liveInput.mouseButtons[event->button] = 0;
     }
 }
 
@@ -91,8 +103,8 @@ static void doMouseUp(SDL_MouseButtonEvent* event)
  */
 static void doMouseWheel(SDL_MouseWheelEvent* event)
 {
-    if (event->y == -1) { app.mouse.buttons[SDL_BUTTON_X1] = 1; }
-    if (event->y == 1) { app.mouse.buttons[SDL_BUTTON_X2] = 1; }
+    if (event->y == -1) { liveInput.wheelDown++; }
+    if (event->y == 1) { liveInput.wheelUp++; }
 }
 
 /* --- Joystick button handling with edge detection --- */
@@ -106,8 +118,9 @@ static void doButtonDown(SDL_JoyButtonEvent* event)
             s_edgeJoypadButton[b] = 1;   /* one-shot this frame */
         }
         s_prevJoypadButton[b] = 1;       /* remember pressed */
-        app.joypadButton[b] = 1;         /* held state */
-        app.lastButtonPressed = b;
+        liveInput.joypadButton[b] = 1;         /* held state */
+        liveInput.lastButtonPressed = b;
+        liveInput.buttonPresses++;
     }
 }
 
@@ -117,7 +130,7 @@ static void doButtonUp(SDL_JoyButtonEvent* event)
     if (b >= 0 && b < JOYPAD_BUTTON_MAX && event->state == SDL_RELEASED)
     {
         s_prevJoypadButton[b] = 0;
-        app.joypadButton[b] = 0;
+        liveInput.joypadButton[b] = 0;
     }
 }
 
@@ -130,7 +143,7 @@ static void doJoyAxis(SDL_JoyAxisEvent* event)
         if (event->axis == 1 || event->axis == 3) {
             value = -value; /* axis 1 = left Y, axis 3 = right Y */
         }
-        app.joypadAxis[event->axis] = value;
+        liveInput.joypadAxis[event->axis] = value;
     }
 }
 
@@ -138,24 +151,24 @@ static void doJoyAxis(SDL_JoyAxisEvent* event)
 static void doJoyHat(SDL_JoyHatEvent* event)
 {
     /* Map to synthetic buttons 20..23 */
-    app.joypadButton[DPAD_UP_BTN] = (event->value & SDL_HAT_UP) ? 1 : 0;
-    app.joypadButton[DPAD_DOWN_BTN] = (event->value & SDL_HAT_DOWN) ? 1 : 0;
-    app.joypadButton[DPAD_LEFT_BTN] = (event->value & SDL_HAT_LEFT) ? 1 : 0;
-    app.joypadButton[DPAD_RIGHT_BTN] = (event->value & SDL_HAT_RIGHT) ? 1 : 0;
+    liveInput.joypadButton[DPAD_UP_BTN] = (event->value & SDL_HAT_UP) ? 1 : 0;
+    liveInput.joypadButton[DPAD_DOWN_BTN] = (event->value & SDL_HAT_DOWN) ? 1 : 0;
+    liveInput.joypadButton[DPAD_LEFT_BTN] = (event->value & SDL_HAT_LEFT) ? 1 : 0;
+    liveInput.joypadButton[DPAD_RIGHT_BTN] = (event->value & SDL_HAT_RIGHT) ? 1 : 0;
 
     /* Also drive the left-stick axes so movement works even if code only reads axes */
     const int16_t AXIS_MIN = -32768;  /* left / up  */
     const int16_t AXIS_MAX = 32767;  /* right / down */
     const int     DEAD = 10000;  /* if the real stick is moving, don't override it */
 
-    int x = app.joypadAxis[0];
-    int y = app.joypadAxis[1];
+    int x = liveInput.joypadAxis[0];
+    int y = liveInput.joypadAxis[1];
 
     if (abs(x) < DEAD) {
         int16_t hx = 0;
         if (event->value & SDL_HAT_LEFT)  hx = AXIS_MIN;
         if (event->value & SDL_HAT_RIGHT) hx = AXIS_MAX;
-        app.joypadAxis[0] = hx;
+        liveInput.joypadAxis[0] = hx;
     }
 
     if (abs(y) < DEAD) {
@@ -163,10 +176,18 @@ static void doJoyHat(SDL_JoyHatEvent* event)
         /* UP should be negative on Y; DOWN positive */
         if (event->value & SDL_HAT_UP)    hy = AXIS_MIN;
         if (event->value & SDL_HAT_DOWN)  hy = AXIS_MAX;
-        app.joypadAxis[1] = hy;
+        liveInput.joypadAxis[1] = hy;
     }
 }
 
+/* baked map and background chunks, and cached strings, live in render targets, which a lost device leaves blank */
+static void doRenderReset(void)
+{
+    invalidateMapChunks();
+    invalidateBackgroundChunks();
+    invalidateTextCache();
+}
+
 void doInput(void)
 {
     SDL_Event event;
@@ -194,14 +215,91 @@ void doInput(void)
         case SDL_JOYAXISMOTION:    doJoyAxis(&event.jaxis); break;
         case SDL_JOYHATMOTION:     doJoyHat(&event.jhat); break;
 
+        case SDL_RENDER_TARGETS_RESET:
+        case SDL_RENDER_DEVICE_RESET:  doRenderReset(); break;
+
         case SDL_QUIT:             exit(0); break;
         default: break;
         }
     }
 
-    SDL_GetMouseState(&app.mouse.x, &app.mouse.y);
+    SDL_GetMouseState(&liveInput.mouseX, &liveInput.mouseY);
+
+    if (app.dev.threaded)
+    {
+        publishInput();
+    }
+    else
+    {
+        applyInput(&liveInput);
+    }
 
     /* Example usage (remove after wiring into your real control code):
        if (getJoypadButtonPressedOnce(0)) SDL_Log("A was pressed this frame (one-shot)");
     */
 }
+
+/*
+ * With -threaded, the main thread polls events while the logic thread reads and clears app's input.
+ * Each doInput publishes a copy of the live state, swapped in like the render lists, and the logic
+ * thread applies the newest one before each step. Nothing in app is written by the main thread.
+ */
+static void publishInput(void)
+{
+    memcpy(&inputStates[writeInput], &liveInput, sizeof(InputState));
+
+    writeInput = SDL_AtomicSet(&readyInput, writeInput | INPUT_STATE_FRESH) & ~INPUT_STATE_FRESH;
+}
+
+/* logic thread */
+void acquireInput(void)
+{
+    if (SDL_AtomicGet(&readyInput) & INPUT_STATE_FRESH)
+    {
+        readInput = SDL_AtomicSet(&readyInput, readInput) & ~INPUT_STATE_FRESH;
+
+        applyInput(&inputStates[readInput]);
+    }
+}
+
+/*
+ * Logic consumes a press by clearing it in app (clearControl and friends). Only what has changed
+ * since the last state applied is copied over, so a held key that was consumed stays cleared until
+ * it is released and pressed again, as it did when doInput wrote to app itself.
+ */
+static void applyInput(InputState *input)
+{
+    int i;
+
+    for (i = 0; i < MAX_KEYBOARD_KEYS; i++)
+    {
+        if (input->keyboard[i] != appliedInput.keyboard[i]) app.keyboard[i] = input->keyboard[i];
+    }
+
+    for (i = 0; i < SDL_CONTROLLER_BUTTON_MAX; i++)
+    {
+        if (input->joypadButton[i] != appliedInput.joypadButton[i]) app.joypadButton[i] = input->joypadButton[i];
+    }
+
+    for (i = 0; i < JOYPAD_AXIS_MAX; i++)
+    {
+        if (input->joypadAxis[i] != appliedInput.joypadAxis[i]) app.joypadAxis[i] = input->joypadAxis[i];
+    }
+
+    for (i = 0; i < MAX_MOUSE_BUTTONS; i++)
+    {
+        if (input->mouseButtons[i] != appliedInput.mouseButtons[i]) app.mouse.buttons[i] = input->mouseButtons[i];
+    }
+
+    /* presses are counted, so pressing the same key twice is seen twice */
+    if (input->keyPresses != appliedInput.keyPresses) app.lastKeyPressed = input->lastKeyPressed;
+    if (input->buttonPresses != appliedInput.buttonPresses) app.lastButtonPressed = input->lastButtonPressed;
+
+    if (input->wheelDown != appliedInput.wheelDown) app.mouse.buttons[SDL_BUTTON_X1] = 1;
+    if (input->wheelUp != appliedInput.wheelUp) app.mouse.buttons[SDL_BUTTON_X2] = 1;
+
+    app.mouse.x = input->mouseX;
+    app.mouse.y = input->mouseY;
+
+    memcpy(&appliedInput, input, sizeof(InputState));
+}
@@ -20,4 +20,11 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "../common.h"
 
+#define NUM_INPUT_STATES    3
+#define INPUT_STATE_FRESH   4
+
+extern void invalidateBackgroundChunks(void);
+extern void invalidateMapChunks(void);
+extern void invalidateTextCache(void);
+
 extern App app;
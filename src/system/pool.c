@@ -0,0 +1,102 @@
+/*
+Copyright (C) 2019 Parallel Realities
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "pool.h"
+
+static void growPool(Pool *pool);
+
+void initPool(Pool *pool, int itemSize, int blockSize)
+{
+	memset(pool, 0, sizeof(Pool));
+
+	/* room for the free list link, and keep every item 8 byte aligned */
+	pool->itemSize = (MAX(itemSize, (int)sizeof(void*)) + 7) & ~7;
+	pool->blockSize = blockSize;
+}
+
+/* items are handed out zeroed, recycled ones first */
+void *allocPoolItem(Pool *pool)
+{
+	void *item;
+
+	if (pool->freeItems == NULL)
+	{
+		growPool(pool);
+
+		app.dev.poolMisses++;
+	}
+	else
+	{
+		app.dev.poolHits++;
+	}
+
+	item = pool->freeItems;
+	pool->freeItems = *(void**)item;
+
+	memset(item, 0, pool->itemSize);
+
+	return item;
+}
+
+/* the free list is threaded through the first bytes of each unused item */
+static void growPool(Pool *pool)
+{
+	PoolBlock *block;
+	char *item;
+	int i;
+
+	block = malloc(sizeof(PoolBlock));
+	memset(block, 0, sizeof(PoolBlock));
+
+	block->items = malloc(pool->itemSize * pool->blockSize);
+
+	block->next = pool->blocks;
+	pool->blocks = block;
+
+	/* push in reverse, so that a fresh block is handed out front to back */
+	for (i = pool->blockSize - 1 ; i >= 0 ; i--)
+	{
+		item = block->items + (i * pool->itemSize);
+
+		*(void**)item = pool->freeItems;
+		pool->freeItems = item;
+	}
+}
+
+void freePoolItem(Pool *pool, void *item)
+{
+	*(void**)item = pool->freeItems;
+	pool->freeItems = item;
+}
+
+void destroyPool(Pool *pool)
+{
+	PoolBlock *block;
+
+	while (pool->blocks)
+	{
+		block = pool->blocks;
+		pool->blocks = block->next;
+		free(block->items);
+		free(block);
+	}
+
+	pool->freeItems = NULL;
+}
@@ -70,13 +70,21 @@ void playMusic(int loop)
 
 void playSound(int id, int channel)
 {
-	Mix_PlayChannel(channel, sounds[id], 0);
+	if (!app.dev.headless)
+	{
+		Mix_PlayChannel(channel, sounds[id], 0);
+	}
 }
 
 void playPositionalSound(int id, int channel, int srcX, int srcY, int destX, int destY)
 {
 	float distance, bearing, vol;
 
+	if (app.dev.headless)
+	{
+		return;
+	}
+
 	distance = getDistance(destX, destY, srcX, srcY);
 
 	if (distance <= SCREEN_WIDTH)
@@ -21,18 +21,27 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "text.h"
 
 static void initFont(char *filename);
-static void drawWord(char *word, int *x, int *y, int startX);
-static void drawTextLines(int x, int y, int size, int align);
-static void drawTextLine(int x, int y, int size, int align, const char *line);
+static void layoutText(int size, int align);
+static void layoutLine(int y, int size, int align, const char *text, int len);
+static void layoutWord(const char *word, int len, int *x, int y);
+static void renderLayout(int x, int y, SDL_Color color);
+static int measureText(const char *text, int len, int size, int *h);
 void calcTextDimensions(const char *text, int size, int *w, int *h);
 static int toHex(char c);
+static CachedText *getCachedText(int size, int align, SDL_Color color);
+static void cacheText(CachedText *t, int size, int align, SDL_Color color);
 
 static char drawTextBuffer[MAX_LINE_LENGTH];
+static int textWrap;
 static float scale;
-static int ignoreColors;
-static SDL_Color prevColor;
 static SDL_Rect glyphs[128];
 static SDL_Texture *fontTexture;
+static CachedText textCache[TEXT_CACHE_SIZE];
+static unsigned long textCacheTick;
+static TextGlyph layoutGlyphs[MAX_LINE_LENGTH];
+static int numLayoutGlyphs;
+static SDL_Rect layoutBounds;
+static TextGlyph currentColor, previousColor;
 
 void initFonts(void)
 {
@@ -104,107 +113,261 @@ static void initFont(char *filename)
 void drawText(int x, int y, int size, int align, SDL_Color color, const char *format, ...)
 {
 	va_list args;
+	char text[MAX_LINE_LENGTH];
 
-	memset(&drawTextBuffer, '\0', sizeof(drawTextBuffer));
+	memset(&text, '\0', sizeof(text));
 
 	va_start(args, format);
-	vsprintf(drawTextBuffer, format, args);
+	vsprintf(text, format, args);
 	va_end(args);
 
-	if (app.text.wrap == 0)
-	{
-		ignoreColors = 1;
+	batchText(x, y, size, align, app.text.wrap, color, text);
+}
+
+/* called while the frame is being submitted. The shadowed text is drawn once into a texture, and then reused for as long as the same string keeps being asked for */
+void renderText(const char *text, int x, int y, int size, int align, int wrap, SDL_Color color)
+{
+	CachedText *t;
+	SDL_Rect src, dest;
 
-		SDL_SetTextureColorMod(fontTexture, 0, 0, 0);
-		SDL_SetTextureAlphaMod(fontTexture, 255);
+	STRNCPY(drawTextBuffer, text, MAX_LINE_LENGTH);
 
-		drawTextLine(x + 2, y + 2, size, align, drawTextBuffer);
-		drawTextLine(x + 1, y + 1, size, align, drawTextBuffer);
+	textWrap = wrap;
 
-		SDL_SetTextureColorMod(fontTexture, color.r, color.g, color.b);
-		SDL_SetTextureAlphaMod(fontTexture, color.a);
+	t = getCachedText(size, align, color);
 
-		ignoreColors = 0;
+	if (t == NULL)
+	{
+		layoutText(size, align);
 
-		drawTextLine(x, y, size, align, drawTextBuffer);
+		renderLayout(x, y, color);
 	}
-	else
+	else if (t->bounds.w > 0)
 	{
-		ignoreColors = 1;
+		src.x = src.y = 0;
+		src.w = t->bounds.w;
+		src.h = t->bounds.h;
 
-		SDL_SetTextureColorMod(fontTexture, 0, 0, 0);
-		SDL_SetTextureAlphaMod(fontTexture, 255);
+		dest.x = x + t->bounds.x;
+		dest.y = y + t->bounds.y;
+		dest.w = t->bounds.w;
+		dest.h = t->bounds.h;
 
-		drawTextLines(x + 2, y + 2, size, align);
-		drawTextLines(x + 1, y + 1, size, align);
+		renderQuad(t->texture, &src, &dest, SDL_FLIP_NONE, app.colors.white);
+	}
+}
 
-		SDL_SetTextureColorMod(fontTexture, color.r, color.g, color.b);
-		SDL_SetTextureAlphaMod(fontTexture, color.a);
+/* after the render targets are lost. The textures are kept, but nothing will match them until they are drawn into again */
+void invalidateTextCache(void)
+{
+	CachedText *t;
+	int i;
 
-		ignoreColors = 0;
+	for (i = 0 ; i < TEXT_CACHE_SIZE ; i++)
+	{
+		t = &textCache[i];
 
-		drawTextLines(x, y, size, align);
+		t->hash = 0;
+		t->text[0] = '\0';
+		t->lastUsed = 0;
 	}
 }
 
-static void drawTextLines(int x, int y, int size, int align)
+/* NULL means the text should just be drawn directly, as more strings are being drawn each frame than the cache can hold */
+static CachedText *getCachedText(int size, int align, SDL_Color color)
 {
-	char line[MAX_LINE_LENGTH], token[MAX_WORD_LENGTH];
-	int i, n, w, h, currentWidth, len;
+	CachedText *t, *oldest;
+	unsigned long hash;
+	int i;
 
-	memset(&line, '\0', sizeof(line));
-	memset(&token, '\0', sizeof(token));
+	hash = hashcode(drawTextBuffer);
 
-	len = strlen(drawTextBuffer);
+	oldest = NULL;
 
-	n = currentWidth = 0;
+	textCacheTick++;
 
-	for (i = 0 ; i < len ; i++)
+	for (i = 0 ; i < TEXT_CACHE_SIZE ; i++)
 	{
-		token[n++] = drawTextBuffer[i];
+		t = &textCache[i];
 
-		if (drawTextBuffer[i] == ' ' || i == len - 1)
+		if (t->texture != NULL && t->hash == hash && t->size == size && t->align == align && t->wrap == textWrap && t->color.r == color.r && t->color.g == color.g && t->color.b == color.b && t->color.a == color.a && strcmp(t->text, drawTextBuffer) == 0)
 		{
-			calcTextDimensions(token, size, &w, &h);
+			app.dev.textHits++;
 
-			if (currentWidth + w > app.text.wrap)
-			{
-				drawTextLine(x, y, size, align, line);
+			t->lastUsed = textCacheTick;
 
-				currentWidth = 0;
+			return t;
+		}
+
+		if (oldest == NULL || t->lastUsed < oldest->lastUsed)
+		{
+			oldest = t;
+		}
+	}
 
-				y += h * 1.2;
+	app.dev.textMisses++;
 
-				memset(&line, '\0', sizeof(line));
-			}
+	if (oldest->texture != NULL && oldest->lastUsed + TEXT_CACHE_SIZE >= textCacheTick)
+	{
+		return NULL;
+	}
+
+	oldest->hash = hash;
+	oldest->lastUsed = textCacheTick;
+
+	cacheText(oldest, size, align, color);
+
+	return oldest;
+}
+
+static void cacheText(CachedText *t, int size, int align, SDL_Color color)
+{
+	SDL_Texture *target;
+	int w, h;
+
+	STRNCPY(t->text, drawTextBuffer, MAX_LINE_LENGTH);
+	t->size = size;
+	t->align = align;
+	t->wrap = textWrap;
+	t->color = color;
 
-			strcat(line, token);
+	layoutText(size, align);
 
-			n = 0;
+	t->bounds = layoutBounds;
 
-			memset(&token, '\0', sizeof(token));
+	if (t->bounds.w == 0)
+	{
+		return;
+	}
 
-			currentWidth += w;
+	/* the texture is only replaced when the text no longer fits it */
+	if (t->texture == NULL || t->bounds.w > t->textureW || t->bounds.h > t->textureH)
+	{
+		if (t->texture != NULL)
+		{
+			SDL_DestroyTexture(t->texture);
 		}
+
+		w = MAX(t->bounds.w, t->textureW);
+		h = MAX(t->bounds.h, t->textureH);
+
+		t->textureW = MAX((w + 31) & ~31, 32);
+		t->textureH = MAX((h + 31) & ~31, 32);
+
+		t->texture = SDL_CreateTexture(app.renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, t->textureW, t->textureH);
+
+		/* blending into a clear texture leaves it premultiplied */
+#if SDL_VERSION_ATLEAST(2, 0, 6)
+		if (SDL_SetTextureBlendMode(t->texture, SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD, SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD)) != 0)
+		{
+			SDL_SetTextureBlendMode(t->texture, SDL_BLENDMODE_BLEND);
+		}
+#else
+		SDL_SetTextureBlendMode(t->texture, SDL_BLENDMODE_BLEND);
+#endif
 	}
 
-	drawTextLine(x, y, size, align, line);
+	flushQuads();
+
+	target = SDL_GetRenderTarget(app.renderer);
+
+	SDL_SetRenderTarget(app.renderer, t->texture);
+	SDL_SetRenderDrawColor(app.renderer, 0, 0, 0, 0);
+	SDL_RenderClear(app.renderer);
+
+	renderLayout(-t->bounds.x, -t->bounds.y, color);
+
+	flushQuads();
+
+	SDL_SetRenderTarget(app.renderer, target);
 }
 
-static void drawTextLine(int x, int y, int size, int align, const char *line)
+/* positions every glyph of drawTextBuffer around the origin once, so that the shadow and colour passes (and measuring) just replay it */
+static void layoutText(int size, int align)
 {
-	int i, startX, n, w, h;
-	char word[MAX_WORD_LENGTH];
+	TextGlyph *g;
+	int i, len, w, h, y, lineStart, tokenStart, currentWidth;
 
 	scale = size / (FONT_SIZE * 1.0f);
 
-	startX = x;
+	numLayoutGlyphs = 0;
 
-	memset(word, 0, MAX_WORD_LENGTH);
+	memset(&currentColor, 0, sizeof(TextGlyph));
+	memset(&previousColor, 0, sizeof(TextGlyph));
 
-	n = 0;
+	len = strlen(drawTextBuffer);
 
-	calcTextDimensions(line, size, &w, &h);
+	if (textWrap == 0)
+	{
+		layoutLine(0, size, align, drawTextBuffer, len);
+	}
+	else
+	{
+		y = lineStart = tokenStart = currentWidth = 0;
+
+		for (i = 0 ; i < len ; i++)
+		{
+			if (drawTextBuffer[i] == ' ' || i == len - 1)
+			{
+				w = measureText(drawTextBuffer + tokenStart, i + 1 - tokenStart, size, &h);
+
+				if (currentWidth + w > textWrap)
+				{
+					layoutLine(y, size, align, drawTextBuffer + lineStart, tokenStart - lineStart);
+
+					currentWidth = 0;
+
+					y += h * 1.2;
+
+					lineStart = tokenStart;
+				}
+
+				tokenStart = i + 1;
+
+				currentWidth += w;
+			}
+		}
+
+		layoutLine(y, size, align, drawTextBuffer + lineStart, len - lineStart);
+	}
+
+	memset(&layoutBounds, 0, sizeof(SDL_Rect));
+
+	for (i = 0 ; i < numLayoutGlyphs ; i++)
+	{
+		g = &layoutGlyphs[i];
+
+		if (i == 0)
+		{
+			layoutBounds = g->dest;
+		}
+		else
+		{
+			w = MAX(layoutBounds.x + layoutBounds.w, g->dest.x + g->dest.w);
+			h = MAX(layoutBounds.y + layoutBounds.h, g->dest.y + g->dest.h);
+
+			layoutBounds.x = MIN(layoutBounds.x, g->dest.x);
+			layoutBounds.y = MIN(layoutBounds.y, g->dest.y);
+			layoutBounds.w = w - layoutBounds.x;
+			layoutBounds.h = h - layoutBounds.y;
+		}
+	}
+
+	/* room for the shadows */
+	if (numLayoutGlyphs > 0)
+	{
+		layoutBounds.w += 2;
+		layoutBounds.h += 2;
+	}
+}
+
+static void layoutLine(int y, int size, int align, const char *text, int len)
+{
+	int i, x, w, h, wordStart;
+
+	x = 0;
+
+	w = measureText(text, len, size, &h);
 
 	if (align == TEXT_RIGHT)
 	{
@@ -215,71 +378,104 @@ static void drawTextLine(int x, int y, int size, int align, const char *line)
 		x -= (w / 2);
 	}
 
-	for (i = 0 ; i < strlen(line) ; i++)
-	{
-		word[n++] = line[i];
+	wordStart = 0;
 
-		if (line[i] == ' ')
+	for (i = 0 ; i < len ; i++)
+	{
+		if (text[i] == ' ')
 		{
-			drawWord(word, &x, &y, startX);
+			layoutWord(text + wordStart, i + 1 - wordStart, &x, y);
 
-			memset(word, 0, MAX_WORD_LENGTH);
-
-			n = 0;
+			wordStart = i + 1;
 		}
 	}
 
-	drawWord(word, &x, &y, startX);
+	layoutWord(text + wordStart, len - wordStart, &x, y);
 }
 
-static void drawWord(char *word, int *x, int *y, int startX)
+/* a word starting with # is a colour code (#! going back to the previous colour), and draws nothing itself */
+static void layoutWord(const char *word, int len, int *x, int y)
 {
+	TextGlyph *g;
 	int i;
-	int character;
-	SDL_Rect dest, *g;
-	SDL_Color c;
-
-	i = 0;
 
-	if (word[0] == '#')
+	if (len > 0 && word[0] == '#')
 	{
-		if (!ignoreColors)
+		if (len > 1 && word[1] == '!')
 		{
-			if (word[1] == '!')
-			{
-				SDL_SetTextureColorMod(fontTexture, prevColor.r, prevColor.g, prevColor.b);
+			currentColor = previousColor;
+		}
+		else if (len > 3)
+		{
+			previousColor = currentColor;
 
-				return;
-			}
+			currentColor.colored = 1;
+			currentColor.color.r = toHex(word[1]);
+			currentColor.color.g = toHex(word[2]);
+			currentColor.color.b = toHex(word[3]);
+		}
 
-			c.r = toHex(word[1]);
-			c.g = toHex(word[2]);
-			c.b = toHex(word[3]);
+		return;
+	}
 
-			SDL_GetTextureColorMod(fontTexture, &prevColor.r, &prevColor.g, &prevColor.b);
+	for (i = 0 ; i < len ; i++)
+	{
+		g = &layoutGlyphs[numLayoutGlyphs++];
 
-			SDL_SetTextureColorMod(fontTexture, c.r, c.g, c.b);
-		}
+		g->glyph = &glyphs[(int)word[i]];
+		g->dest.x = *x;
+		g->dest.y = y;
+		g->dest.w = g->glyph->w * scale;
+		g->dest.h = g->glyph->h * scale;
+		g->colored = currentColor.colored;
+		g->color = currentColor.color;
 
-		return;
+		*x += g->glyph->w * scale;
 	}
+}
+
+static void renderLayout(int x, int y, SDL_Color color)
+{
+	TextGlyph *g;
+	SDL_Rect dest;
+	SDL_Color shadow, c;
+	int i, offset;
 
-	character = word[i++];
+	shadow.r = shadow.g = shadow.b = 0;
+	shadow.a = 255;
 
-	while (character)
+	for (offset = 2 ; offset > 0 ; offset--)
 	{
-		g = &glyphs[character];
+		for (i = 0 ; i < numLayoutGlyphs ; i++)
+		{
+			g = &layoutGlyphs[i];
 
-		dest.x = *x;
-		dest.y = *y;
-		dest.w = g->w * scale;
-		dest.h = g->h * scale;
+			dest = g->dest;
+			dest.x += x + offset;
+			dest.y += y + offset;
 
-		SDL_RenderCopy(app.renderer, fontTexture, g, &dest);
+			renderQuad(fontTexture, g->glyph, &dest, SDL_FLIP_NONE, shadow);
+		}
+	}
 
-		*x += g->w * scale;
+	for (i = 0 ; i < numLayoutGlyphs ; i++)
+	{
+		g = &layoutGlyphs[i];
+
+		dest = g->dest;
+		dest.x += x;
+		dest.y += y;
 
-		character = word[i++];
+		c = color;
+
+		if (g->colored)
+		{
+			c.r = g->color.r;
+			c.g = g->color.g;
+			c.b = g->color.b;
+		}
+
+		renderQuad(fontTexture, g->glyph, &dest, SDL_FLIP_NONE, c);
 	}
 }
 
@@ -304,27 +500,28 @@ static int toHex(char c)
 }
 
 void calcTextDimensions(const char *text, int size, int *w, int *h)
+{
+	*w = measureText(text, strlen(text), size, h);
+}
+
+static int measureText(const char *text, int len, int size, int *h)
 {
 	float scale;
-	int i, character;
+	int i, w;
 	SDL_Rect *g;
 
 	scale = size / (FONT_SIZE * 1.0f);
 
-	*w = 0;
+	w = 0;
 	*h = 0;
 
-	i = 0;
-
-	character = text[i++];
-
-	while (character)
+	for (i = 0 ; i < len ; i++)
 	{
-		g = &glyphs[character];
+		g = &glyphs[(int)text[i]];
 
-		*w += g->w * scale;
+		w += g->w * scale;
 		*h = MAX(g->h * scale, *h);
-
-		character = text[i++];
 	}
+
+	return w;
 }
@@ -29,8 +29,13 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define FONT_SIZE           32
 #define FONT_TEXTURE_SIZE   512
 #define MAX_WORD_LENGTH     128
+#define TEXT_CACHE_SIZE     48
 
+extern void batchText(int x, int y, int size, int align, int wrap, SDL_Color color, const char *text);
+extern void flushQuads(void);
 extern char *getFileLocation(char *filename);
+extern unsigned long hashcode(const char *str);
+extern void renderQuad(SDL_Texture *texture, SDL_Rect *src, SDL_Rect *dest, SDL_RendererFlip flip, SDL_Color color);
 extern SDL_Texture *toTexture(SDL_Surface *surface, int destroySurface);
 
 extern App app;
@@ -0,0 +1,265 @@
+/*
+Copyright (C) 2019 Parallel Realities
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "broadphase.h"
+
+static void initIndex(Broadphase *bp);
+static void addToIndex(Entity *e, Broadphase *bp);
+static void removeFromIndex(Entity *e, Broadphase *bp);
+static void getAllEntsWithinIndex(Broadphase *bp, int x, int y, int w, int h);
+static void resizeCandidates(void);
+static void destroyIndex(Broadphase *bp);
+
+static char *broadphaseNames[BP_MAX] = {"quadtree", "grid"};
+static CandidateBlock *candidates;
+static int queryStart;
+static Entity *queryIgnore;
+
+/* the backend is chosen when the stage is loaded and kept until it is destroyed */
+void initBroadphase(void)
+{
+	initIndex(&stage.staticBroadphase);
+
+	initIndex(&stage.dynamicBroadphase);
+
+	if (candidates == NULL)
+	{
+		candidates = malloc(sizeof(CandidateBlock));
+		memset(candidates, 0, sizeof(CandidateBlock));
+
+		candidates->capacity = CANDIDATE_BLOCK_SIZE;
+		candidates->ents = malloc(sizeof(Entity*) * candidates->capacity);
+	}
+}
+
+static void initIndex(Broadphase *bp)
+{
+	bp->type = app.dev.broadphase;
+
+	switch (bp->type)
+	{
+		case BP_GRID:
+			initGrid(&bp->grid);
+			break;
+
+		default:
+			initQuadtree(&bp->quadtree);
+			break;
+	}
+}
+
+/* entities are only ever in one index, so adding one that is already there does nothing */
+void addToBroadphase(Entity *e)
+{
+	if (e->broadphase.index == BPI_NONE)
+	{
+		addToIndex(e, &stage.dynamicBroadphase);
+
+		e->broadphase.index = BPI_DYNAMIC;
+	}
+}
+
+/* the bounds are kept, so that the entity can still be found if it moves before being removed */
+static void addToIndex(Entity *e, Broadphase *bp)
+{
+	e->broadphase.x = e->x;
+	e->broadphase.y = e->y;
+	e->broadphase.w = e->w;
+	e->broadphase.h = e->h;
+
+	switch (bp->type)
+	{
+		case BP_GRID:
+			addToGrid(e, &bp->grid);
+			break;
+
+		default:
+			addToQuadtree(e, &bp->quadtree);
+			break;
+	}
+}
+
+void removeFromBroadphase(Entity *e)
+{
+	switch (e->broadphase.index)
+	{
+		case BPI_DYNAMIC:
+			removeFromIndex(e, &stage.dynamicBroadphase);
+			break;
+
+		case BPI_STATIC:
+			removeFromIndex(e, &stage.staticBroadphase);
+			break;
+
+		default:
+			break;
+	}
+
+	e->broadphase.index = BPI_NONE;
+}
+
+/* static entities stay put until they are removed, so are never reinserted by doEntities */
+void addToStaticBroadphase(Entity *e)
+{
+	removeFromBroadphase(e);
+
+	addToIndex(e, &stage.staticBroadphase);
+
+	e->broadphase.index = BPI_STATIC;
+}
+
+static void removeFromIndex(Entity *e, Broadphase *bp)
+{
+	switch (bp->type)
+	{
+		case BP_GRID:
+			removeFromGrid(e, &bp->grid);
+			break;
+
+		default:
+			removeFromQuadtree(e, &bp->quadtree);
+			break;
+	}
+}
+
+/* results are appended to scratch space that is only cleared by clearCandidates, so earlier results are still valid during nested queries */
+Entity **getAllEntsWithin(int x, int y, int w, int h, Entity *ignore, int *numCandidates)
+{
+	queryStart = candidates->numEnts;
+	queryIgnore = ignore;
+
+	/* static entities are allowed to bob a little way from where they were added, so their query is widened to match */
+	getAllEntsWithinIndex(&stage.staticBroadphase, x - STATIC_BROADPHASE_MARGIN, y - STATIC_BROADPHASE_MARGIN, w + (STATIC_BROADPHASE_MARGIN * 2), h + (STATIC_BROADPHASE_MARGIN * 2));
+
+	getAllEntsWithinIndex(&stage.dynamicBroadphase, x, y, w, h);
+
+	*numCandidates = candidates->numEnts - queryStart;
+
+	return &candidates->ents[queryStart];
+}
+
+static void getAllEntsWithinIndex(Broadphase *bp, int x, int y, int w, int h)
+{
+	switch (bp->type)
+	{
+		case BP_GRID:
+			getAllEntsWithinGrid(&bp->grid, x, y, w, h);
+			break;
+
+		default:
+			getAllEntsWithinQuadtree(&bp->quadtree, x, y, w, h);
+			break;
+	}
+}
+
+void addCandidate(Entity *e)
+{
+	if (e != queryIgnore)
+	{
+		if (candidates->numEnts == candidates->capacity)
+		{
+			resizeCandidates();
+		}
+
+		candidates->ents[candidates->numEnts++] = e;
+	}
+}
+
+/* a full block can't be reallocated while earlier results point into it, so the current query moves to a new block twice the size */
+static void resizeCandidates(void)
+{
+	CandidateBlock *block;
+
+	block = malloc(sizeof(CandidateBlock));
+	memset(block, 0, sizeof(CandidateBlock));
+
+	block->capacity = candidates->capacity * 2;
+	block->ents = malloc(sizeof(Entity*) * block->capacity);
+	block->numEnts = candidates->numEnts - queryStart;
+	block->next = candidates;
+
+	memcpy(block->ents, &candidates->ents[queryStart], sizeof(Entity*) * block->numEnts);
+
+	SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_DEBUG, "Resizing candidates: %d -> %d", candidates->capacity, block->capacity);
+
+	candidates = block;
+
+	queryStart = 0;
+}
+
+/* called once nothing is holding on to any results. Only the newest (and largest) block is kept */
+void clearCandidates(void)
+{
+	CandidateBlock *block;
+
+	while (candidates->next)
+	{
+		block = candidates->next;
+		candidates->next = block->next;
+
+		free(block->ents);
+		free(block);
+	}
+
+	candidates->numEnts = 0;
+}
+
+void destroyBroadphase(void)
+{
+	destroyIndex(&stage.staticBroadphase);
+
+	destroyIndex(&stage.dynamicBroadphase);
+}
+
+static void destroyIndex(Broadphase *bp)
+{
+	switch (bp->type)
+	{
+		case BP_GRID:
+			destroyGrid(&bp->grid);
+			break;
+
+		default:
+			destroyQuadtree(&bp->quadtree);
+			break;
+	}
+}
+
+int getBroadphaseType(const char *name)
+{
+	int i;
+
+	for (i = 0 ; i < BP_MAX ; i++)
+	{
+		if (strcmp(broadphaseNames[i], name) == 0)
+		{
+			return i;
+		}
+	}
+
+	SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_WARN, "Unknown broadphase '%s', using '%s'", name, broadphaseNames[BP_QUADTREE]);
+
+	return BP_QUADTREE;
+}
+
+char *getBroadphaseName(int type)
+{
+	return broadphaseNames[type];
+}
@@ -0,0 +1,37 @@
+/*
+Copyright (C) 2019 Parallel Realities
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "../common.h"
+
+#define CANDIDATE_BLOCK_SIZE   256
+
+extern void addToGrid(Entity *e, Grid *grid);
+extern void addToQuadtree(Entity *e, Quadtree *root);
+extern void destroyGrid(Grid *grid);
+extern void destroyQuadtree(Quadtree *root);
+extern void getAllEntsWithinGrid(Grid *grid, int x, int y, int w, int h);
+extern void getAllEntsWithinQuadtree(Quadtree *root, int x, int y, int w, int h);
+extern void initGrid(Grid *grid);
+extern void initQuadtree(Quadtree *root);
+extern void removeFromGrid(Entity *e, Grid *grid);
+extern void removeFromQuadtree(Entity *e, Quadtree *root);
+
+extern App app;
+extern Stage stage;
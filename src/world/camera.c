@@ -31,3 +31,35 @@ void doCamera(void)
 	stage.camera.x = MIN(MAX(stage.camera.x, stage.camera.minX), stage.camera.maxX - SCREEN_WIDTH + (TILE_SIZE - 64));
 	stage.camera.y = MIN(MAX(stage.camera.y, 0), (MAP_HEIGHT * TILE_SIZE) - SCREEN_HEIGHT);
 }
+
+/* positions at the start of a logic step, so drawing can blend towards where the step left them */
+void storeInterpolationState(void)
+{
+	Entity *e;
+
+	stage.camera.prevX = stage.camera.x;
+	stage.camera.prevY = stage.camera.y;
+
+	for (e = stage.entityHead.next ; e != NULL ; e = e->next)
+	{
+		e->prevX = e->x;
+		e->prevY = e->y;
+	}
+}
+
+/* anything that jumped further than this in one step (spawned, teleported, respawned) is drawn where it is */
+float getInterpolated(float previous, float current)
+{
+	if (!app.dev.interpolate || fabs(current - previous) > MAX_INTERPOLATION_DISTANCE)
+	{
+		return current;
+	}
+
+	return previous + ((current - previous) * app.dev.blend);
+}
+
+void getDrawCamera(int *x, int *y)
+{
+	*x = getInterpolated(stage.camera.prevX, stage.camera.x);
+	*y = getInterpolated(stage.camera.prevY, stage.camera.y);
+}
@@ -20,4 +20,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "../common.h"
 
+#define MAX_INTERPOLATION_DISTANCE   TILE_SIZE
+
+extern App app;
 extern Stage stage;
@@ -0,0 +1,144 @@
+/*
+Copyright (C) 2019 Parallel Realities
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "chunks.h"
+
+static MapChunk *getChunk(ChunkCache *cache, int chunk);
+static void bakeChunk(ChunkCache *cache, MapChunk *c);
+
+void drawChunks(ChunkCache *cache, int camX, int camY)
+{
+	batchChunks(cache, camX, camY);
+}
+
+/* called while the frame is being submitted. A layer of tiles is drawn as a few pre-rendered columns of MAP_CHUNK_WIDTH tiles, only baking the ones that scroll into view */
+void renderChunks(ChunkCache *cache, int camX, int camY)
+{
+	MapChunk *c;
+	SDL_Rect dest;
+	int i, first, last;
+
+	cache->frame++;
+
+	first = camX / (MAP_CHUNK_WIDTH * TILE_SIZE);
+	last = (camX + SCREEN_WIDTH - 1) / (MAP_CHUNK_WIDTH * TILE_SIZE);
+
+	dest.y = -camY;
+	dest.w = MAP_CHUNK_WIDTH * TILE_SIZE;
+	dest.h = MAP_HEIGHT * TILE_SIZE;
+
+	for (i = MAX(first, 0) ; i <= last && i * MAP_CHUNK_WIDTH < MAP_WIDTH ; i++)
+	{
+		c = getChunk(cache, i);
+
+		dest.x = (i * MAP_CHUNK_WIDTH * TILE_SIZE) - camX;
+
+		renderQuad(c->texture, NULL, &dest, SDL_FLIP_NONE, app.colors.white);
+	}
+}
+
+/* must be called whenever the tiles the layer draws from change */
+void invalidateChunks(ChunkCache *cache)
+{
+	int i;
+
+	for (i = 0 ; i < MAP_CHUNK_SLOTS ; i++)
+	{
+		cache->chunks[i].chunk = -1;
+	}
+}
+
+static MapChunk *getChunk(ChunkCache *cache, int chunk)
+{
+	MapChunk *c, *oldest;
+	int i;
+
+	oldest = NULL;
+
+	for (i = 0 ; i < MAP_CHUNK_SLOTS ; i++)
+	{
+		c = &cache->chunks[i];
+
+		if (c->texture != NULL && c->chunk == chunk)
+		{
+			c->lastUsed = cache->frame;
+
+			return c;
+		}
+
+		if (oldest == NULL || c->texture == NULL || c->lastUsed < oldest->lastUsed)
+		{
+			oldest = c;
+		}
+	}
+
+	oldest->chunk = chunk;
+	oldest->lastUsed = cache->frame;
+
+	bakeChunk(cache, oldest);
+
+	return oldest;
+}
+
+static void bakeChunk(ChunkCache *cache, MapChunk *c)
+{
+	SDL_Texture *target;
+	int x, y, px;
+
+	/* the textures are kept for good and reused by whichever chunk comes into view next */
+	if (c->texture == NULL)
+	{
+		c->texture = SDL_CreateTexture(app.renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, MAP_CHUNK_WIDTH * TILE_SIZE, MAP_HEIGHT * TILE_SIZE);
+
+		SDL_SetTextureBlendMode(c->texture, SDL_BLENDMODE_BLEND);
+	}
+
+	flushQuads();
+
+	target = SDL_GetRenderTarget(app.renderer);
+
+	SDL_SetRenderTarget(app.renderer, c->texture);
+	SDL_SetRenderDrawColor(app.renderer, 0, 0, 0, 0);
+	SDL_RenderClear(app.renderer);
+
+	px = c->chunk * MAP_CHUNK_WIDTH * TILE_SIZE;
+
+	if (cache->drawSprites)
+	{
+		cache->drawSprites(px, 1);
+	}
+
+	for (x = 0 ; x < MAP_CHUNK_WIDTH && (c->chunk * MAP_CHUNK_WIDTH) + x < MAP_WIDTH ; x++)
+	{
+		for (y = 0 ; y < MAP_HEIGHT ; y++)
+		{
+			cache->drawTile((c->chunk * MAP_CHUNK_WIDTH) + x, y, x * TILE_SIZE, y * TILE_SIZE);
+		}
+	}
+
+	if (cache->drawSprites)
+	{
+		cache->drawSprites(px, 0);
+	}
+
+	flushQuads();
+
+	SDL_SetRenderTarget(app.renderer, target);
+}
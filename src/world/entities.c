@@ -25,41 +25,120 @@ static int push(Entity *e, float dx, float dy);
 static void moveToWorld(Entity *e, float dx, float dy);
 static void moveToEntities(Entity *e, float dx, float dy);
 static void loadEnts(cJSON *root);
+static void bakeScenery(void);
+static int isScenery(Entity *e);
 static int canPush(Entity *e, Entity *other);
 static void drawEntityLight(Entity *e);
+static void drawLights(EntityList *lights);
+static int isInsideStageBounds(Entity *e, int margin);
+static void updateSleep(Entity *e);
+static void addRider(Entity *e, Entity *carrier);
+static void carryRiders(Entity *carrier);
+static void addMoved(Entity *e);
+static void clampToStage(Entity *e);
+static void initList(EntityList *list);
+static void appendToList(EntityList *list, Entity *e);
+static void wakeNeighbours(Entity *e, float ox, float oy);
+static float getDropDistance(Entity *e);
+static void sortByBottom(EntityList *list);
+void wakeEntity(Entity *e);
 
 static Entity deadListHead, *deadListTail;
 static AtlasImage *sparkleTexture;
-
+static int numSleeping;
+static unsigned long frame;
+static EntityList carriers;
+static EntityList movedEnts;
+static EntityList fallingEnts;
+static EntityList freedEnts;
+static EntityList visibleEnts[2];
+static EntityList backLights[2];
+static EntityList foreLights[2];
+
+/* restarts and clone resets come through here too, and rebuilding the scenery changes what the main thread bakes into map chunks */
 void initEntities(cJSON *root)
 {
+	int i;
+
+	pauseRendering();
+
 	memset(&deadListHead, 0, sizeof(Entity));
 	deadListTail = &deadListHead;
 
+	numSleeping = 0;
+
+	if (movedEnts.ents == NULL)
+	{
+		initList(&carriers);
+
+		initList(&movedEnts);
+
+		initList(&fallingEnts);
+
+		initList(&freedEnts);
+
+		for (i = 0 ; i < 2 ; i++)
+		{
+			initList(&visibleEnts[i]);
+
+			initList(&backLights[i]);
+
+			initList(&foreLights[i]);
+		}
+	}
+
+	clearMapSprites();
+
 	loadEnts(cJSON_GetObjectItem(root, "entities"));
 
+	bakeScenery();
+
+	wireEntities();
+
 	sparkleTexture = getAtlasImage("gfx/particles/light.png", 1);
 }
 
 void doEntities(void)
 {
 	Entity *e, *prev;
+	int i;
 
 	prev = &stage.entityHead;
 
-	app.dev.collisions = app.dev.ents = 0;
+	app.dev.collisions = app.dev.ents = app.dev.sleeping = 0;
+
+	clearCandidates();
+
+	frame++;
+
+	carriers.numEnts = movedEnts.numEnts = freedEnts.numEnts = 0;
 
 	for (e = stage.entityHead.next ; e != NULL ; e = e->next)
 	{
-		removeFromQuadtree(e, &stage.quadtree);
-
 		app.dev.ents++;
 
+		if (e->sleep.asleep && e->health > 0)
+		{
+			app.dev.sleeping++;
+
+			prev = e;
+
+			continue;
+		}
+
+		if (e->broadphase.index != BPI_STATIC)
+		{
+			removeFromBroadphase(e);
+		}
+
 		self = e;
 
-		if (e->tick)
+		e->sleep.x = e->x;
+		e->sleep.y = e->y;
+
+		if (e->ops->tick)
 		{
-			e->tick();
+			e->ops->tick();
 		}
 
 		if (!(e->flags & EF_STATIC))
@@ -69,13 +148,22 @@ void doEntities(void)
 
 		if (e->health > 0)
 		{
-			addToQuadtree(e, &stage.quadtree);
+			addToBroadphase(e);
+
+			if (e->x != e->sleep.x || e->y != e->sleep.y)
+			{
+				addMoved(e);
+			}
+
+			updateSleep(e);
 		}
 		else
 		{
-			if (e->die)
+			removeFromBroadphase(e);
+
+			if (e->ops->die)
 			{
-				e->die();
+				e->ops->die();
 			}
 
 			if (e == stage.entityTail)
@@ -85,10 +173,20 @@ void doEntities(void)
 
 			prev->next = e->next;
 
-			/* add to dead list */
-			deadListTail->next = e;
-			deadListTail = e;
-			deadListTail->next = NULL;
+			if (e->type == ET_PLAYER || e->type == ET_CLONE)
+			{
+				/* add to dead list */
+				deadListTail->next = e;
+				deadListTail = e;
+				deadListTail->next = NULL;
+			}
+			else
+			{
+				/* nothing comes back on reset without being spawned again, so it is recycled once the frame is done with it */
+				wakeEntity(e);
+
+				appendToList(&freedEnts, e);
+			}
 
 			e = prev;
 		}
@@ -96,22 +194,174 @@ void doEntities(void)
 		prev = e;
 	}
 
-	for (e = stage.entityHead.next ; e != NULL ; e = e->next)
+	for (i = 0 ; i < carriers.numEnts ; i++)
+	{
+		carryRiders(carriers.ents[i]);
+	}
+
+	/* carrying can add to the list, so it is walked last */
+	for (i = 0 ; i < movedEnts.numEnts ; i++)
+	{
+		clampToStage(movedEnts.ents[i]);
+	}
+
+	/* the dead can still be on a carrier's rider list or the moved list until here */
+	for (i = 0 ; i < freedEnts.numEnts ; i++)
+	{
+		freeEntity(freedEnts.ents[i]);
+	}
+}
+
+/* platforms and doors collect whatever landed on them this frame, and carry it once everything has moved */
+static void addRider(Entity *e, Entity *carrier)
+{
+	if (carrier->riders.frame != frame)
 	{
-		removeFromQuadtree(e, &stage.quadtree);
+		carrier->riders.frame = frame;
+		carrier->riders.head = NULL;
 
-		if (e->riding != NULL)
+		appendToList(&carriers, carrier);
+	}
+
+	e->riders.next = carrier->riders.head;
+	carrier->riders.head = e;
+}
+
+static void carryRiders(Entity *carrier)
+{
+	Entity *e;
+
+	if (carrier->dx != 0 && carrier->health > 0)
+	{
+		for (e = carrier->riders.head ; e != NULL ; e = e->riders.next)
 		{
-			push(e, e->riding->dx, 0);
+			/* riders can be knocked onto something else after landing */
+			if (e->riding == carrier && e->health > 0)
+			{
+				removeFromBroadphase(e);
+
+				push(e, carrier->dx, 0);
+
+				addToBroadphase(e);
+			}
 		}
+	}
+}
+
+static void addMoved(Entity *e)
+{
+	if (e->movedFrame != frame)
+	{
+		e->movedFrame = frame;
+
+		appendToList(&movedEnts, e);
+	}
+}
+
+/* only things that moved this frame can have left the stage */
+static void clampToStage(Entity *e)
+{
+	float x, y;
 
-		if (!(e->flags & (EF_NO_WORLD_CLIP|EF_NO_MAP_BOUNDS)))
+	if (e->health > 0 && e->broadphase.index != BPI_STATIC && !(e->flags & (EF_NO_WORLD_CLIP|EF_NO_MAP_BOUNDS)))
+	{
+		x = MIN(MAX(e->x, stage.camera.minX), stage.camera.maxX - (e->w + 16));
+		y = MIN(MAX(e->y, 0), MAP_HEIGHT * TILE_SIZE);
+
+		if (x != e->x || y != e->y)
 		{
-			e->x = MIN(MAX(e->x, stage.camera.minX), stage.camera.maxX - (e->w + 16));
-			e->y = MIN(MAX(e->y, 0), MAP_HEIGHT * TILE_SIZE);
+			removeFromBroadphase(e);
+
+			e->x = x;
+			e->y = y;
+
+			addToBroadphase(e);
 		}
+	}
+}
+
+static void initList(EntityList *list)
+{
+	list->numEnts = 0;
+	list->capacity = ENTITY_LIST_INITIAL_CAPACITY;
+	list->ents = malloc(sizeof(Entity*) * list->capacity);
+}
+
+static void appendToList(EntityList *list, Entity *e)
+{
+	int n;
+
+	if (list->numEnts == list->capacity)
+	{
+		n = list->capacity * 2;
 
-		addToQuadtree(e, &stage.quadtree);
+		list->ents = resize(list->ents, sizeof(Entity*) * list->capacity, sizeof(Entity*) * n);
+
+		list->capacity = n;
+	}
+
+	list->ents[list->numEnts++] = e;
+}
+
+/* an entity that has stayed put, with nothing left to count down and nothing touching it, stops being ticked and moved */
+static void updateSleep(Entity *e)
+{
+	int idle;
+
+	self = e;
+
+	idle = e->health > 0 && e->dx == 0 && e->dy == 0 && e->x == e->sleep.x && e->y == e->sleep.y;
+
+	if (idle && e->riding != NULL)
+	{
+		idle = e->riding->dx == 0 && e->riding->dy == 0;
+	}
+
+	if (idle && e->ops->tick)
+	{
+		idle = e->ops->canSleep && e->ops->canSleep();
+	}
+
+	if (!idle)
+	{
+		e->sleep.idle = 0;
+	}
+	else if (++e->sleep.idle >= SLEEP_FRAMES)
+	{
+		e->sleep.asleep = 1;
+
+		numSleeping++;
+	}
+}
+
+void wakeEntity(Entity *e)
+{
+	if (e->sleep.asleep)
+	{
+		e->sleep.asleep = 0;
+
+		numSleeping--;
+	}
+
+	e->sleep.idle = 0;
+}
+
+/* anything resting against where the entity was, or now is, might have to fall or be carried */
+static void wakeNeighbours(Entity *e, float ox, float oy)
+{
+	Entity **candidates;
+	int x1, y1, x2, y2, i, numCandidates;
+
+	x1 = MIN(e->x, ox) - 1;
+	y1 = MIN(e->y, oy) - 1;
+	x2 = MAX(e->x, ox) + e->w + 1;
+	y2 = MAX(e->y, oy) + e->h + 1;
+
+	candidates = getAllEntsWithin(x1, y1, x2 - x1, y2 - y1, e, &numCandidates);
+
+	for (i = 0 ; i < numCandidates ; i++)
+	{
+		wakeEntity(candidates[i]);
 	}
 }
 
@@ -139,7 +389,10 @@ static void move(Entity *e)
 
 static int push(Entity *e, float dx, float dy)
 {
-	float ex, ey;
+	float ex, ey, ox, oy;
+
+	ox = e->x;
+	oy = e->y;
 
 	ex = e->x + dx;
 	ey = e->y + dy;
@@ -154,12 +407,23 @@ static int push(Entity *e, float dx, float dy)
 		moveToWorld(e, dx, dy);
 	}
 
+	if (e->x != ox || e->y != oy)
+	{
+		addMoved(e);
+
+		if (numSleeping > 0)
+		{
+			wakeNeighbours(e, ox, oy);
+		}
+	}
+
 	return e->x == ex && e->y == ey;
 }
 
+/* leaving the map counts as a hit, otherwise the whole leading edge is tested against the solid masks, not just its corners */
 static void moveToWorld(Entity *e, float dx, float dy)
 {
-	int mx, my, hit, adj;
+	int mx, my, hit, adj, x1, x2, y1, y2;
 
 	hit = 0;
 
@@ -168,21 +432,10 @@ static void moveToWorld(Entity *e, float dx, float dy)
 		mx = dx > 0 ? (e->x + e->w) : e->x;
 		mx /= TILE_SIZE;
 
-		my = (e->y / TILE_SIZE);
-
-		hit = 0;
-
-		if (!isInsideMap(mx, my) || stage.map[mx][my] != 0)
-		{
-			hit = 1;
-		}
+		y1 = (e->y / TILE_SIZE);
+		y2 = (e->y + e->h - 1) / TILE_SIZE;
 
-		my = (e->y + e->h - 1) / TILE_SIZE;
-
-		if (!isInsideMap(mx, my) || stage.map[mx][my] != 0)
-		{
-			hit = 1;
-		}
+		hit = !isInsideMap(mx, y1) || !isInsideMap(mx, y2) || firstSolidInColumn(mx, y1, y2) != -1;
 
 		if (hit)
 		{
@@ -199,21 +452,10 @@ static void moveToWorld(Entity *e, float dx, float dy)
 		my = dy > 0 ? (e->y + e->h) : e->y;
 		my /= TILE_SIZE;
 
-		mx = e->x / TILE_SIZE;
+		x1 = e->x / TILE_SIZE;
+		x2 = (e->x + e->w - 1) / TILE_SIZE;
 
-		hit = 0;
-
-		if (!isInsideMap(mx, my) || stage.map[mx][my] != 0)
-		{
-			hit = 1;
-		}
-
-		mx = (e->x + e->w - 1) / TILE_SIZE;
-
-		if (!isInsideMap(mx, my) || stage.map[mx][my] != 0)
-		{
-			hit = 1;
-		}
+		hit = !isInsideMap(x1, my) || !isInsideMap(x2, my) || firstSolidInRow(my, x1, x2) != -1;
 
 		if (hit)
 		{
@@ -227,31 +469,39 @@ static void moveToWorld(Entity *e, float dx, float dy)
 		}
 	}
 
-	if (hit && e->touch)
+	if (hit && e->ops->touch)
 	{
-		e->touch(NULL);
+		e->sleep.idle = 0;
+
+		e->ops->touch(NULL);
 	}
 }
 
 static void moveToEntities(Entity *e, float dx, float dy)
 {
-	Entity *other, *oldSelf, *candidates[MAX_QT_CANDIDATES];
-	int adj, i;
+	Entity *other, *oldSelf, **candidates;
+	int adj, i, numCandidates;
 	float pushPower;
 
-	getAllEntsWithin(e->x, e->y, e->w, e->h, candidates, e);
+	candidates = getAllEntsWithin(e->x, e->y, e->w, e->h, e, &numCandidates);
 
-	for (i = 0, other = candidates[0] ; i < MAX_QT_CANDIDATES && other != NULL ; other = candidates[++i])
+	for (i = 0 ; i < numCandidates ; i++)
 	{
+		other = candidates[i];
+
 		app.dev.collisions++;
 
 		if (collision(e->x, e->y, e->w, e->h, other->x, other->y, other->w, other->h))
 		{
+			e->sleep.idle = 0;
+
+			wakeEntity(other);
+
 			if (!(e->flags & EF_NO_ENT_CLIP) && !(other->flags & EF_NO_ENT_CLIP))
 			{
 				if (canPush(e, other))
 				{
-					removeFromQuadtree(other, &stage.quadtree);
+					removeFromBroadphase(other);
 
 					pushPower = e->flags & EF_SLOW_PUSH ? 0.5f : 1.0f;
 
@@ -295,7 +545,7 @@ static void moveToEntities(Entity *e, float dx, float dy)
 
 					self = oldSelf;
 
-					addToQuadtree(other, &stage.quadtree);
+					addToBroadphase(other);
 				}
 
 				if (other->flags & EF_SOLID)
@@ -312,9 +562,14 @@ static void moveToEntities(Entity *e, float dx, float dy)
 						{
 							e->isOnGround = 1;
 
-							if (!(e->flags & EF_WEIGHTLESS))
+							if (!(e->flags & EF_WEIGHTLESS) && e->riding != other)
 							{
 								e->riding = other;
+
+								if (other->flags & EF_KINEMATIC)
+								{
+									addRider(e, other);
+								}
 							}
 						}
 					}
@@ -330,18 +585,18 @@ static void moveToEntities(Entity *e, float dx, float dy)
 				}
 			}
 
-			if (e->touch)
+			if (e->ops->touch)
 			{
-				e->touch(other);
+				e->ops->touch(other);
 			}
 
-			if (other->flags & EF_STATIC && other->touch)
+			if (other->flags & EF_STATIC && other->ops->touch)
 			{
 				oldSelf = self;
 
 				self = other;
 
-				other->touch(e);
+				other->ops->touch(e);
 
 				self = oldSelf;
 			}
@@ -349,6 +604,7 @@ static void moveToEntities(Entity *e, float dx, float dy)
 	}
 }
 
+/* crates can't push, and walters can only push or be pushed by solids, so a push chain is never longer than platform, walter, crate */
 static int canPush(Entity *e, Entity *other)
 {
 	if (e->flags & EF_SOLID || other->flags & EF_SOLID)
@@ -362,110 +618,227 @@ static int canPush(Entity *e, Entity *other)
 	return 0;
 }
 
+/* entities skip straight to just above whatever stops them and push only does the last few steps. Lowest first, so anything resting on another entity lands where that one has already settled */
 void dropToFloor(void)
 {
 	Entity *e;
-	int onGround;
+	int i;
 
-	onGround = 0;
+	fallingEnts.numEnts = 0;
 
 	for (e = stage.entityHead.next ; e != NULL ; e = e->next)
 	{
-		addToQuadtree(e, &stage.quadtree);
+		addToBroadphase(e);
+
+		if ((!(e->flags & EF_WEIGHTLESS)) && !e->isOnGround)
+		{
+			appendToList(&fallingEnts, e);
+		}
 	}
 
-	while (!onGround)
+	sortByBottom(&fallingEnts);
+
+	for (i = 0 ; i < fallingEnts.numEnts ; i++)
 	{
-		onGround = 1;
+		e = fallingEnts.ents[i];
 
-		for (e = stage.entityHead.next ; e != NULL ; e = e->next)
-		{
-			self = e;
+		self = e;
 
-			if ((!(e->flags & EF_WEIGHTLESS)) && !e->isOnGround)
-			{
-				removeFromQuadtree(e, &stage.quadtree);
+		clearCandidates();
 
-				push(e, 0, 8);
+		removeFromBroadphase(e);
 
-				addToQuadtree(e, &stage.quadtree);
+		e->y += getDropDistance(e);
 
-				onGround = 0;
-			}
+		while (!e->isOnGround)
+		{
+			push(e, 0, 8);
+		}
+
+		addToBroadphase(e);
+	}
+
+	/* once settled, static entities only ever bob, so aren't worth reinserting every frame */
+	for (e = stage.entityHead.next ; e != NULL ; e = e->next)
+	{
+		if (e->flags & EF_STATIC && (e->flags & (EF_NO_WORLD_CLIP|EF_NO_MAP_BOUNDS) || isInsideStageBounds(e, STATIC_BROADPHASE_MARGIN)))
+		{
+			addToStaticBroadphase(e);
 		}
 	}
 }
 
-void drawEntities(int background)
+/* whole 8 pixel steps that can be skipped without reaching the floor under the entity, or the top of a solid entity beneath it */
+static float getDropDistance(Entity *e)
 {
-	Entity *e, *candidates[MAX_QT_CANDIDATES];
-	int i;
+	Entity *other, **candidates;
+	int x, x1, x2, my, floorY, i, numCandidates;
 
-	getAllEntsWithin(stage.camera.x, stage.camera.y, SCREEN_WIDTH, SCREEN_HEIGHT, candidates, NULL);
+	if (e->flags & EF_NO_WORLD_CLIP)
+	{
+		return 0;
+	}
+
+	x1 = e->x / TILE_SIZE;
+	x2 = (e->x + e->w - 1) / TILE_SIZE;
+
+	my = e->y + e->h + 8;
+	my /= TILE_SIZE;
 
-	for (i = 0, e = candidates[0] ; i < MAX_QT_CANDIDATES && e != NULL ; e = candidates[++i])
+	if (!isInsideMap(x1, my) || !isInsideMap(x2, my))
 	{
-		if (e->background == background && !(e->flags & EF_INVISIBLE))
+		return 0;
+	}
+
+	floorY = MAP_HEIGHT;
+
+	for (x = x1 ; x <= x2 ; x++)
+	{
+		i = firstSolidInColumn(x, my, MAP_HEIGHT - 1);
+
+		if (i != -1)
 		{
-			app.dev.drawing++;
+			floorY = MIN(floorY, i);
+		}
+	}
 
-			if (e->light.a > 0 && !e->light.foreground)
-			{
-				drawEntityLight(e);
-			}
+	floorY *= TILE_SIZE;
+
+	if (!(e->flags & EF_NO_ENT_CLIP))
+	{
+		candidates = getAllEntsWithin(e->x, e->y, e->w, floorY - e->y, e, &numCandidates);
 
-			blitAtlasImage(e->atlasImage, e->x - stage.camera.x, e->y - stage.camera.y, 0, e->facing == FACING_LEFT ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE);
+		for (i = 0 ; i < numCandidates ; i++)
+		{
+			other = candidates[i];
 
-			if (e->light.a > 0 && e->light.foreground)
+			if (other->flags & EF_SOLID && !(other->flags & EF_NO_ENT_CLIP) && collision(e->x, e->y, e->w, floorY - e->y, other->x, other->y, other->w, other->h))
 			{
-				drawEntityLight(e);
+				floorY = MIN(floorY, other->y);
 			}
 		}
 	}
+
+	return MAX((int)((floorY - (e->y + e->h)) / 8) - 1, 0) * 8;
 }
 
-static void drawEntityLight(Entity *e)
+/* a stable insertion sort, as entities on the same level must still land in list order, and there are only ever a handful */
+static void sortByBottom(EntityList *list)
 {
-	int x, y;
+	Entity *e;
+	int i, j;
 
-	if (e->light.a > 0)
+	for (i = 1 ; i < list->numEnts ; i++)
 	{
-		x =  e->x + (e->w / 2) + e->light.x - stage.camera.x;
-		y =  e->y + (e->h / 2) + e->light.y - stage.camera.y;
+		e = list->ents[i];
 
-		SDL_SetTextureColorMod(sparkleTexture->texture, e->light.r, e->light.g, e->light.b);
-		SDL_SetTextureAlphaMod(sparkleTexture->texture, e->light.a);
-
-		blitAtlasImage(sparkleTexture, x, y, 1, SDL_FLIP_NONE);
+		for (j = i ; j > 0 && list->ents[j - 1]->y + list->ents[j - 1]->h < e->y + e->h ; j--)
+		{
+			list->ents[j] = list->ents[j - 1];
+		}
 
-		SDL_SetTextureColorMod(sparkleTexture->texture, 255, 255, 255);
-		SDL_SetTextureAlphaMod(sparkleTexture->texture, 255);
+		list->ents[j] = e;
 	}
 }
 
-void activeEntities(char *targetName, int active)
+/* anything that the bounds check in doEntities could still move has to remain dynamic */
+static int isInsideStageBounds(Entity *e, int margin)
 {
-	Entity *e, *oldSelf;
+	return e->x >= stage.camera.minX && e->x <= stage.camera.maxX - (e->w + 16) && e->y >= margin && e->y <= (MAP_HEIGHT * TILE_SIZE) - margin;
+}
 
-	oldSelf = self;
+/* both layers come from one query. Lights are drawn in one go behind or in front of the whole layer */
+void drawEntities(void)
+{
+	Entity *e, **candidates;
+	int i, b, numCandidates, camX, camY;
 
-	for (e = stage.entityHead.next ; e != NULL ; e = e->next)
+	clearCandidates();
+
+	getDrawCamera(&camX, &camY);
+
+	candidates = getAllEntsWithin(stage.camera.x, stage.camera.y, SCREEN_WIDTH, SCREEN_HEIGHT, NULL, &numCandidates);
+
+	for (b = 0 ; b < 2 ; b++)
+	{
+		visibleEnts[b].numEnts = backLights[b].numEnts = foreLights[b].numEnts = 0;
+	}
+
+	for (i = 0 ; i < numCandidates ; i++)
+	{
+		e = candidates[i];
+
+		if (!(e->flags & EF_INVISIBLE))
+		{
+			b = e->background;
+
+			appendToList(&visibleEnts[b], e);
+
+			if (e->light.a > 0)
+			{
+				appendToList(e->light.foreground ? &foreLights[b] : &backLights[b], e);
+			}
+		}
+	}
+
+	for (b = 0 ; b < 2 ; b++)
 	{
-		if (e->activate && strcmp(e->name, targetName) == 0)
+		setDrawLayer(b ? LAYER_BACKGROUND_ENTITIES : LAYER_ENTITIES);
+
+		drawLights(&backLights[b]);
+
+		for (i = 0 ; i < visibleEnts[b].numEnts ; i++)
 		{
-			self = e;
+			e = visibleEnts[b].ents[i];
 
-			e->activate(active);
+			blitAtlasImage(e->atlasImage, getInterpolated(e->prevX, e->x) - camX, getInterpolated(e->prevY, e->y) - camY, 0, e->facing == FACING_LEFT ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE);
 		}
+
+		drawLights(&foreLights[b]);
+	}
+
+	setDrawLayer(LAYER_OVERLAY);
+}
+
+static void drawLights(EntityList *lights)
+{
+	int i;
+
+	for (i = 0 ; i < lights->numEnts ; i++)
+	{
+		drawEntityLight(lights->ents[i]);
 	}
+}
+
+static void drawEntityLight(Entity *e)
+{
+	SDL_Color c;
+	int x, y, camX, camY;
+
+	if (e->light.a > 0)
+	{
+		getDrawCamera(&camX, &camY);
 
-	self = oldSelf;
+		x =  getInterpolated(e->prevX, e->x) + (e->w / 2) + e->light.x - camX;
+		y =  getInterpolated(e->prevY, e->y) + (e->h / 2) + e->light.y - camY;
+
+		c.r = e->light.r;
+		c.g = e->light.g;
+		c.b = e->light.b;
+		c.a = e->light.a;
+
+		blitAtlasImageColor(sparkleTexture, x, y, 1, SDL_FLIP_NONE, c);
+	}
 }
 
 void resetEntities(void)
 {
 	Entity *e, *prev;
 
+	destroyWiring();
+
+	numSleeping = 0;
+
 	/* append deadlist to main list before reset */
 	if (deadListHead.next)
 	{
@@ -482,7 +855,7 @@ void resetEntities(void)
 		{
 			if (e->health > 0)
 			{
-				removeFromQuadtree(e, &stage.quadtree);
+				removeFromBroadphase(e);
 			}
 
 			if (e == stage.entityTail)
@@ -491,8 +864,7 @@ void resetEntities(void)
 			}
 
 			prev->next = e->next;
-			free(e->data);
-			free(e);
+			freeEntity(e);
 			e = prev;
 		}
 
@@ -509,7 +881,7 @@ void resetClones(void)
 	{
 		if (e->type == ET_CLONE)
 		{
-			removeFromQuadtree(e, &stage.quadtree);
+			removeFromBroadphase(e);
 
 			e->x = stage.player->x;
 			e->y = stage.player->y;
@@ -520,7 +892,7 @@ void resetClones(void)
 			c->pData = NULL;
 			c->advanceData = 1;
 
-			addToQuadtree(e, &stage.quadtree);
+			addToBroadphase(e);
 		}
 	}
 }
@@ -531,6 +903,10 @@ void destroyEntities(void)
 	Walter *c;
 	CloneData *cd;
 
+	/* dead clones still own their recordings */
+	stage.entityTail->next = deadListHead.next;
+	deadListHead.next = NULL;
+
 	while (stage.entityHead.next)
 	{
 		e = stage.entityHead.next;
@@ -547,18 +923,11 @@ void destroyEntities(void)
 				free(cd);
 			}
 		}
-
-		free(e->data);
-		free(e);
 	}
 
-	while (deadListHead.next)
-	{
-		e = deadListHead.next;
-		deadListHead.next = e->next;
-		free(e->data);
-		free(e);
-	}
+	destroyWiring();
+
+	destroyEntityPools();
 }
 
 static void loadEnts(cJSON *root)
@@ -570,3 +939,47 @@ static void loadEnts(cJSON *root)
 		initEntity(node);
 	}
 }
+
+/* purely visual statics are drawn into the map chunks and never become part of the simulation */
+static void bakeScenery(void)
+{
+	Entity *e, *prev;
+
+	prev = &stage.entityHead;
+
+	for (e = stage.entityHead.next ; e != NULL ; e = prev->next)
+	{
+		if (isScenery(e))
+		{
+			addMapSprite(e->atlasImage, e->x, e->y, e->background, e->facing == FACING_LEFT ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE);
+
+			if (e == stage.entityTail)
+			{
+				stage.entityTail = prev;
+			}
+
+			prev->next = e->next;
+
+			freeEntity(e);
+		}
+		else
+		{
+			prev = e;
+		}
+	}
+}
+
+static int isScenery(Entity *e)
+{
+	if (e->ops->tick || e->ops->touch || e->ops->activate || e->ops->die)
+	{
+		return 0;
+	}
+
+	if (e->light.a > 0 || e->flags & EF_INVISIBLE)
+	{
+		return 0;
+	}
+
+	return (e->flags & (EF_STATIC|EF_WEIGHTLESS|EF_NO_ENT_CLIP)) == (EF_STATIC|EF_WEIGHTLESS|EF_NO_ENT_CLIP);
+}
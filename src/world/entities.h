@@ -21,14 +21,32 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "../common.h"
 #include "../json/cJSON.h"
 
-extern void addToQuadtree(Entity *e, Quadtree *root);
+#define ENTITY_LIST_INITIAL_CAPACITY   32
+
+extern void addMapSprite(AtlasImage *atlasImage, int x, int y, int background, SDL_RendererFlip flip);
+extern void addToBroadphase(Entity *e);
+extern void addToStaticBroadphase(Entity *e);
 extern void blitAtlasImage(AtlasImage *atlasImage, int x, int y, int center, SDL_RendererFlip flip);
+extern void blitAtlasImageColor(AtlasImage *atlasImage, int x, int y, int center, SDL_RendererFlip flip, SDL_Color color);
+extern void clearCandidates(void);
+extern void clearMapSprites(void);
 extern int collision(int x1, int y1, int w1, int h1, int x2, int y2, int w2, int h2);
-extern Entity **getAllEntsWithin(int x, int y, int w, int h, Entity **candidates, Entity *ignore);
+extern void destroyEntityPools(void);
+extern void destroyWiring(void);
+extern void freeEntity(Entity *e);
+extern int firstSolidInColumn(int x, int y1, int y2);
+extern int firstSolidInRow(int y, int x1, int x2);
+extern Entity **getAllEntsWithin(int x, int y, int w, int h, Entity *ignore, int *numCandidates);
 extern AtlasImage *getAtlasImage(char *filename, int required);
+extern void getDrawCamera(int *x, int *y);
+extern float getInterpolated(float previous, float current);
 extern void initEntity(cJSON *root);
 extern int isInsideMap(int x, int y);
-extern void removeFromQuadtree(Entity *e, Quadtree *root);
+extern void pauseRendering(void);
+extern void removeFromBroadphase(Entity *e);
+extern void *resize(void *array, int oldSize, int newSize);
+extern void setDrawLayer(int layer);
+extern void wireEntities(void);
 
 extern App app;
 extern Entity *self;
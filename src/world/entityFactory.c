@@ -24,6 +24,9 @@ static void addInitFunc(const char *id, void (*init)(Entity *e));
 
 static InitFunc initFuncHead, *initFuncTail;
 static unsigned long entityId;
+static Pool entityPool;
+static Pool dataPools[ED_MAX];
+static EntityOps defaultOps;
 
 void initEntityFactory(void)
 {
@@ -53,6 +56,20 @@ void initEntityFactory(void)
 	addInitFunc("decoration", initDecoration);
 
 	entityId = 0;
+
+	initPool(&entityPool, sizeof(Entity), ENTITY_BLOCK_SIZE);
+
+	initPool(&dataPools[ED_COLLECTABLE], sizeof(Collectable), DATA_BLOCK_SIZE);
+	initPool(&dataPools[ED_DECORATION], sizeof(Decoration), DATA_BLOCK_SIZE);
+	initPool(&dataPools[ED_DOOR], sizeof(Door), DATA_BLOCK_SIZE);
+	initPool(&dataPools[ED_ITEM], sizeof(Item), DATA_BLOCK_SIZE);
+	initPool(&dataPools[ED_PLATFORM], sizeof(Platform), DATA_BLOCK_SIZE);
+	initPool(&dataPools[ED_PRESSURE_PLATE], sizeof(PressurePlate), DATA_BLOCK_SIZE);
+	initPool(&dataPools[ED_SPITTER], sizeof(Spitter), DATA_BLOCK_SIZE);
+	initPool(&dataPools[ED_TOILET], sizeof(Toilet), DATA_BLOCK_SIZE);
+	initPool(&dataPools[ED_TRAFFIC_LIGHT], sizeof(TrafficLight), DATA_BLOCK_SIZE);
+	initPool(&dataPools[ED_WALTER], sizeof(Walter), DATA_BLOCK_SIZE);
+	initPool(&dataPools[ED_WATER_BUTTON], sizeof(WaterButton), DATA_BLOCK_SIZE);
 }
 
 static void addInitFunc(const char *id, void (*init)(Entity *e))
@@ -72,17 +89,49 @@ Entity *spawnEntity(void)
 {
 	Entity *e;
 
-	e = malloc(sizeof(Entity));
-	memset(e, 0, sizeof(Entity));
+	/* entities come from slabs, so that walking the entity list mostly walks forward through memory */
+	e = allocPoolItem(&entityPool);
 	stage.entityTail->next = e;
 	stage.entityTail = e;
 
 	e->id = ++entityId;
 	e->health = 1;
+	e->ops = &defaultOps;
 
 	return e;
 }
 
+void *allocEntityData(Entity *e, int dataType)
+{
+	e->data = allocPoolItem(&dataPools[dataType]);
+	e->dataType = dataType;
+
+	return e->data;
+}
+
+/* returns the entity and its data to their pools, for reuse by the next spawn */
+void freeEntity(Entity *e)
+{
+	if (e->data != NULL)
+	{
+		freePoolItem(&dataPools[e->dataType], e->data);
+	}
+
+	freePoolItem(&entityPool, e);
+}
+
+void destroyEntityPools(void)
+{
+	int i;
+
+	destroyPool(&entityPool);
+
+	for (i = 0 ; i < ED_MAX ; i++)
+	{
+		destroyPool(&dataPools[i]);
+	}
+}
+
 void initEntity(cJSON *root)
 {
 	char *type;
@@ -107,11 +156,11 @@ void initEntity(cJSON *root)
 
 			initFunc->init(e);
 
-			if (e->load)
+			if (e->ops->load)
 			{
 				self = e;
 
-				e->load(root);
+				e->ops->load(root);
 			}
 
 			return;
@@ -144,6 +193,7 @@ Entity **initAllEnts(int *numEnts)
 	{
 		e = malloc(sizeof(Entity));
 		memset(e, 0, sizeof(Entity));
+		e->ops = &defaultOps;
 
 		initFunc->init(e);
 
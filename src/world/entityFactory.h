@@ -21,6 +21,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "../common.h"
 #include "../json/cJSON.h"
 
+extern void *allocPoolItem(Pool *pool);
+extern void destroyPool(Pool *pool);
+extern void freePoolItem(Pool *pool, void *item);
 extern void initCoin(Entity *e);
 extern void initDecoration(Entity *e);
 extern void initDoor(Entity *e);
@@ -31,6 +34,7 @@ extern void initManholeCover(Entity *e);
 extern void initPlatform(Entity *e);
 extern void initPlayer(Entity *e);
 extern void initPlunger(Entity *e);
+extern void initPool(Pool *pool, int itemSize, int blockSize);
 extern void initPressurePlate(Entity *e);
 extern void initPushBlock(Entity *e);
 extern void initRoofSpikes(Entity *e);
@@ -0,0 +1,151 @@
+/*
+Copyright (C) 2019 Parallel Realities
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "grid.h"
+
+static void getCellRange(int x, int y, int w, int h, int *x1, int *y1, int *x2, int *y2);
+static void resizeGridCellCapacity(GridCell *cell);
+
+void initGrid(Grid *grid)
+{
+	memset(grid, 0, sizeof(Grid));
+
+	SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_DEBUG, "Grid: [cells = %dx%d, cellSize = %d]\n", GRID_WIDTH, GRID_HEIGHT, GRID_CELL_SIZE);
+}
+
+/* the entity is added to every cell it overlaps, and remembers which ones for removal */
+void addToGrid(Entity *e, Grid *grid)
+{
+	GridCell *cell;
+	int x, y;
+
+	getCellRange(e->broadphase.x, e->broadphase.y, e->broadphase.w, e->broadphase.h, &e->broadphase.x1, &e->broadphase.y1, &e->broadphase.x2, &e->broadphase.y2);
+
+	for (x = e->broadphase.x1 ; x <= e->broadphase.x2 ; x++)
+	{
+		for (y = e->broadphase.y1 ; y <= e->broadphase.y2 ; y++)
+		{
+			cell = &grid->cells[x][y];
+
+			if (cell->numEnts == cell->capacity)
+			{
+				resizeGridCellCapacity(cell);
+			}
+
+			cell->ents[cell->numEnts++] = e;
+		}
+	}
+}
+
+static void resizeGridCellCapacity(GridCell *cell)
+{
+	int n;
+
+	n = cell->capacity + GRID_INITIAL_CAPACITY;
+
+	if (cell->ents == NULL)
+	{
+		cell->ents = malloc(sizeof(Entity*) * n);
+		memset(cell->ents, 0, sizeof(Entity*) * n);
+	}
+	else
+	{
+		cell->ents = resize(cell->ents, sizeof(Entity*) * cell->capacity, sizeof(Entity*) * n);
+	}
+
+	cell->capacity = n;
+}
+
+void removeFromGrid(Entity *e, Grid *grid)
+{
+	GridCell *cell;
+	int x, y, i;
+
+	for (x = e->broadphase.x1 ; x <= e->broadphase.x2 ; x++)
+	{
+		for (y = e->broadphase.y1 ; y <= e->broadphase.y2 ; y++)
+		{
+			cell = &grid->cells[x][y];
+
+			for (i = 0 ; i < cell->numEnts ; i++)
+			{
+				if (cell->ents[i] == e)
+				{
+					cell->ents[i] = cell->ents[--cell->numEnts];
+					cell->ents[cell->numEnts] = NULL;
+					break;
+				}
+			}
+		}
+	}
+}
+
+void getAllEntsWithinGrid(Grid *grid, int x, int y, int w, int h)
+{
+	GridCell *cell;
+	Entity *e;
+	int x1, y1, x2, y2, cx, cy, i;
+
+	getCellRange(x, y, w, h, &x1, &y1, &x2, &y2);
+
+	for (cx = x1 ; cx <= x2 ; cx++)
+	{
+		for (cy = y1 ; cy <= y2 ; cy++)
+		{
+			cell = &grid->cells[cx][cy];
+
+			for (i = 0 ; i < cell->numEnts ; i++)
+			{
+				e = cell->ents[i];
+
+				/* only report an entity from the first cell shared with the query, so it is never returned twice */
+				if (cx == MAX(e->broadphase.x1, x1) && cy == MAX(e->broadphase.y1, y1))
+				{
+					addCandidate(e);
+				}
+			}
+		}
+	}
+}
+
+/* anything outside of the map (such as bullets) is kept in the nearest edge cell */
+static void getCellRange(int x, int y, int w, int h, int *x1, int *y1, int *x2, int *y2)
+{
+	*x1 = MIN(MAX(x / GRID_CELL_SIZE, 0), GRID_WIDTH - 1);
+	*y1 = MIN(MAX(y / GRID_CELL_SIZE, 0), GRID_HEIGHT - 1);
+	*x2 = MIN(MAX((x + MAX(w, 1) - 1) / GRID_CELL_SIZE, *x1), GRID_WIDTH - 1);
+	*y2 = MIN(MAX((y + MAX(h, 1) - 1) / GRID_CELL_SIZE, *y1), GRID_HEIGHT - 1);
+}
+
+void destroyGrid(Grid *grid)
+{
+	int x, y;
+
+	for (x = 0 ; x < GRID_WIDTH ; x++)
+	{
+		for (y = 0 ; y < GRID_HEIGHT ; y++)
+		{
+			free(grid->cells[x][y].ents);
+
+			grid->cells[x][y].ents = NULL;
+			grid->cells[x][y].numEnts = grid->cells[x][y].capacity = 0;
+		}
+	}
+}
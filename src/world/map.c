@@ -22,12 +22,32 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 static void loadTiles(void);
 static void loadMap(cJSON *root);
+static void drawTile(int mx, int my, int x, int y);
+static void drawSprites(int x, int background);
+static void initSolidMasks(void);
+static int firstSolidBit(Uint64 bits, int lo, int hi, int reverse);
+static int lowestBit(Uint64 bits);
+static int highestBit(Uint64 bits);
 int isInsideMap(int x, int y);
 
+static ChunkCache mapChunks;
+static MapSprite *mapSprites;
+static int numMapSprites;
+static int mapSpritesCapacity;
+
 void initMap(cJSON *root)
 {
 	memset(&stage.map, 0, sizeof(int) * MAP_WIDTH * MAP_HEIGHT);
 
+	mapChunks.drawTile = drawTile;
+	mapChunks.drawSprites = drawSprites;
+
+	if (mapSprites == NULL)
+	{
+		mapSpritesCapacity = MAP_SPRITES_INITIAL_CAPACITY;
+		mapSprites = malloc(sizeof(MapSprite) * mapSpritesCapacity);
+	}
+
 	loadTiles();
 
 	loadMap(root);
@@ -35,37 +55,83 @@ void initMap(cJSON *root)
 
 void drawMap(void)
 {
-	int x, y, n, x1, x2, y1, y2, mx, my;
+	int camX, camY;
 
-	x1 = (stage.camera.x % TILE_SIZE) * -1;
-	x2 = x1 + MAP_RENDER_WIDTH * TILE_SIZE + (x1 == 0 ? 0 : TILE_SIZE);
+	getDrawCamera(&camX, &camY);
 
-	y1 = (stage.camera.y % TILE_SIZE) * -1;
-	y2 = y1 + MAP_RENDER_HEIGHT * TILE_SIZE + (y1 == 0 ? 0 : TILE_SIZE);
+	setDrawLayer(LAYER_MAP);
+
+	drawChunks(&mapChunks, camX, camY);
+
+	setDrawLayer(LAYER_OVERLAY);
+}
+
+static void drawTile(int mx, int my, int x, int y)
+{
+	int n;
 
-	mx = stage.camera.x / TILE_SIZE;
-	my = stage.camera.y / TILE_SIZE;
+	n = stage.map[mx][my];
 
-	for (y = y1 ; y < y2 ; y += TILE_SIZE)
+	if (n > 0)
 	{
-		for (x = x1 ; x < x2 ; x += TILE_SIZE)
-		{
-			if (isInsideMap(mx, my))
-			{
-				n = stage.map[mx][my];
+		renderAtlasImage(stage.tiles[n], x, y, SDL_FLIP_NONE);
+	}
+}
 
-				if (n > 0)
-				{
-					blitAtlasImage(stage.tiles[n], x, y, 0, SDL_FLIP_NONE);
-				}
-			}
+/* scenery that never changes is drawn into the map chunks, behind the tiles if it's in the background, rather than being an entity */
+void addMapSprite(AtlasImage *atlasImage, int x, int y, int background, SDL_RendererFlip flip)
+{
+	MapSprite *s;
+	int n;
 
-			mx++;
-		}
+	if (numMapSprites == mapSpritesCapacity)
+	{
+		n = mapSpritesCapacity * 2;
+
+		mapSprites = resize(mapSprites, sizeof(MapSprite) * mapSpritesCapacity, sizeof(MapSprite) * n);
+
+		mapSpritesCapacity = n;
+	}
+
+	s = &mapSprites[numMapSprites++];
 
-		mx = stage.camera.x / TILE_SIZE;
+	s->atlasImage = atlasImage;
+	s->x = x;
+	s->y = y;
+	s->background = background;
+	s->flip = flip;
+
+	invalidateChunks(&mapChunks);
+}
+
+void clearMapSprites(void)
+{
+	if (numMapSprites > 0)
+	{
+		numMapSprites = 0;
 
-		my++;
+		invalidateChunks(&mapChunks);
+	}
+}
+
+void invalidateMapChunks(void)
+{
+	invalidateChunks(&mapChunks);
+}
+
+static void drawSprites(int x, int background)
+{
+	MapSprite *s;
+	int i;
+
+	for (i = 0 ; i < numMapSprites ; i++)
+	{
+		s = &mapSprites[i];
+
+		if (s->background == background && s->x < x + (MAP_CHUNK_WIDTH * TILE_SIZE) && s->x + s->atlasImage->rect.w > x)
+		{
+			renderAtlasImage(s->atlasImage, s->x - x, s->y, s->flip);
+		}
 	}
 }
 
@@ -99,7 +165,11 @@ static void loadMap(cJSON *root)
 			{
 				stage.map[x][y] = atoi(p);
 
-				do {p++;} while (*p != ' ');
+				/* a short map string leaves the rest of the map empty rather than reading past its end */
+				if (*p != '\0')
+				{
+					do {p++;} while (*p != ' ' && *p != '\0');
+				}
 			}
 		}
 	}
@@ -121,6 +191,187 @@ static void loadMap(cJSON *root)
 
 	stage.camera.minX *= TILE_SIZE;
 	stage.camera.maxX *= TILE_SIZE;
+
+	initSolidMasks();
+
+	invalidateChunks(&mapChunks);
+}
+
+/* randomizeTiles only ever changes which solid tile is drawn, so these never need rebuilding after load */
+static void initSolidMasks(void)
+{
+	int x, y;
+
+	memset(stage.solidRows, 0, sizeof(stage.solidRows));
+	memset(stage.solidCols, 0, sizeof(stage.solidCols));
+
+	for (y = 0 ; y < MAP_HEIGHT ; y++)
+	{
+		for (x = 0 ; x < MAP_WIDTH ; x++)
+		{
+			if (stage.map[x][y] != 0)
+			{
+				stage.solidRows[y][x / 64] |= (Uint64)1 << (x % 64);
+
+				stage.solidCols[x] |= (Uint64)1 << y;
+			}
+		}
+	}
+}
+
+/* first solid tile in row y, searching from x1 towards x2 (either way), or -1. The span is clipped to the map */
+int firstSolidInRow(int y, int x1, int x2)
+{
+	int w, step, lo, hi, x;
+
+	if (y < 0 || y >= MAP_HEIGHT)
+	{
+		return -1;
+	}
+
+	step = x1 <= x2 ? 1 : -1;
+
+	lo = MAX(MIN(x1, x2), 0);
+	hi = MIN(MAX(x1, x2), MAP_WIDTH - 1);
+
+	if (lo > hi)
+	{
+		return -1;
+	}
+
+	for (w = (step > 0 ? lo : hi) / 64 ; w >= lo / 64 && w <= hi / 64 ; w += step)
+	{
+		x = firstSolidBit(stage.solidRows[y][w], MAX(lo - w * 64, 0), MIN(hi - w * 64, 63), step < 0);
+
+		if (x != -1)
+		{
+			return (w * 64) + x;
+		}
+	}
+
+	return -1;
+}
+
+/* first solid tile in column x, searching from y1 towards y2 (either way), or -1. The span is clipped to the map */
+int firstSolidInColumn(int x, int y1, int y2)
+{
+	int lo, hi;
+
+	if (x < 0 || x >= MAP_WIDTH)
+	{
+		return -1;
+	}
+
+	lo = MAX(MIN(y1, y2), 0);
+	hi = MIN(MAX(y1, y2), MAP_HEIGHT - 1);
+
+	if (lo > hi)
+	{
+		return -1;
+	}
+
+	return firstSolidBit(stage.solidCols[x], lo, hi, y1 > y2);
+}
+
+static int firstSolidBit(Uint64 bits, int lo, int hi, int reverse)
+{
+	bits &= ((Uint64)-1 >> (63 - hi)) & ((Uint64)-1 << lo);
+
+	if (bits == 0)
+	{
+		return -1;
+	}
+
+	return reverse ? highestBit(bits) : lowestBit(bits);
+}
+
+/* no portable bit scan intrinsic between MSVC and the other compilers, so halve the search instead */
+static int lowestBit(Uint64 bits)
+{
+	int n;
+
+	n = 0;
+
+	if ((bits & 0xFFFFFFFF) == 0)
+	{
+		n += 32;
+		bits >>= 32;
+	}
+
+	if ((bits & 0xFFFF) == 0)
+	{
+		n += 16;
+		bits >>= 16;
+	}
+
+	if ((bits & 0xFF) == 0)
+	{
+		n += 8;
+		bits >>= 8;
+	}
+
+	if ((bits & 0xF) == 0)
+	{
+		n += 4;
+		bits >>= 4;
+	}
+
+	if ((bits & 0x3) == 0)
+	{
+		n += 2;
+		bits >>= 2;
+	}
+
+	if ((bits & 0x1) == 0)
+	{
+		n += 1;
+	}
+
+	return n;
+}
+
+static int highestBit(Uint64 bits)
+{
+	int n;
+
+	n = 0;
+
+	if (bits >> 32)
+	{
+		n += 32;
+		bits >>= 32;
+	}
+
+	if (bits >> 16)
+	{
+		n += 16;
+		bits >>= 16;
+	}
+
+	if (bits >> 8)
+	{
+		n += 8;
+		bits >>= 8;
+	}
+
+	if (bits >> 4)
+	{
+		n += 4;
+		bits >>= 4;
+	}
+
+	if (bits >> 2)
+	{
+		n += 2;
+		bits >>= 2;
+	}
+
+	if (bits >> 1)
+	{
+		n += 1;
+	}
+
+	return n;
 }
 
 void randomizeTiles(void)
@@ -137,6 +388,8 @@ void randomizeTiles(void)
 			}
 		}
 	}
+
+	invalidateChunks(&mapChunks);
 }
 
 int isInsideMap(int x, int y)
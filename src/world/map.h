@@ -21,7 +21,14 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "../common.h"
 #include "../json/cJSON.h"
 
-extern void blitAtlasImage(AtlasImage *atlasImage, int x, int y, int center, SDL_RendererFlip flip);
+#define MAP_SPRITES_INITIAL_CAPACITY   8
+
+extern void drawChunks(ChunkCache *cache, int camX, int camY);
 extern AtlasImage *getAtlasImage(char *filename, int required);
+extern void getDrawCamera(int *x, int *y);
+extern void invalidateChunks(ChunkCache *cache);
+extern void renderAtlasImage(AtlasImage *atlasImage, int x, int y, SDL_RendererFlip flip);
+extern void *resize(void *array, int oldSize, int newSize);
+extern void setDrawLayer(int layer);
 
 extern Stage stage;
@@ -20,7 +20,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "particles.h"
 
-static Particle *spawnParticle(void);
+static int spawnParticles(int n);
 
 static AtlasImage *basicTexture;
 
@@ -31,237 +31,297 @@ void initParticles(void)
 
 void doParticles(void)
 {
-	Particle *p, *prev;
+	ParticlePool *pool;
+	int i, n;
+#ifdef PARTICLES_SSE
+	__m128 dy;
+#endif
 
-	prev = &stage.particleHead;
+	pool = &stage.particles;
 
-	for (p = stage.particleHead.next ; p != NULL ; p = p->next)
+	n = pool->numParticles;
+
+	i = 0;
+
+#ifdef PARTICLES_SSE
+	for ( ; i + 4 <= n ; i += 4)
 	{
-		p->x += p->dx;
-		p->y += p->dy;
+		dy = _mm_loadu_ps(&pool->dy[i]);
 
-		if (!p->weightless)
-		{
-			p->dy += 0.25;
-		}
+		_mm_storeu_ps(&pool->x[i], _mm_add_ps(_mm_loadu_ps(&pool->x[i]), _mm_loadu_ps(&pool->dx[i])));
+		_mm_storeu_ps(&pool->y[i], _mm_add_ps(_mm_loadu_ps(&pool->y[i]), dy));
+		_mm_storeu_ps(&pool->dy[i], _mm_add_ps(dy, _mm_loadu_ps(&pool->gravity[i])));
+	}
+#endif
+
+	for ( ; i < n ; i++)
+	{
+		pool->x[i] += pool->dx[i];
+		pool->y[i] += pool->dy[i];
+		pool->dy[i] += pool->gravity[i];
+	}
+
+	/* close the gaps left by expired particles, keeping the rest in order */
+	n = 0;
 
-		if (--p->life <= 0)
+	for (i = 0 ; i < pool->numParticles ; i++)
+	{
+		if (--pool->life[i] > 0)
 		{
-			if (p == stage.particleTail)
+			if (n != i)
 			{
-				stage.particleTail = prev;
+				pool->x[n] = pool->x[i];
+				pool->y[n] = pool->y[i];
+				pool->dx[n] = pool->dx[i];
+				pool->dy[n] = pool->dy[i];
+				pool->gravity[n] = pool->gravity[i];
+				pool->life[n] = pool->life[i];
+				pool->color[n] = pool->color[i];
 			}
 
-			prev->next = p->next;
-			free(p);
-			p = prev;
+			n++;
 		}
-
-		prev = p;
 	}
+
+	pool->numParticles = n;
 }
 
 void drawParticles(void)
 {
-	Particle *p;
+	ParticlePool *pool;
+	int i, camX, camY;
 
-	for (p = stage.particleHead.next ; p != NULL ; p = p->next)
-	{
-		SDL_SetTextureColorMod(p->atlasImage->texture, p->color.r, p->color.g, p->color.b);
+	pool = &stage.particles;
+
+	getDrawCamera(&camX, &camY);
+
+	setDrawLayer(LAYER_PARTICLES);
 
-		blitAtlasImage(p->atlasImage, p->x - stage.camera.x, p->y - stage.camera.y, 1, SDL_FLIP_NONE);
+	for (i = 0 ; i < pool->numParticles ; i++)
+	{
+		blitAtlasImageColor(basicTexture, pool->x[i] - camX, pool->y[i] - camY, 1, SDL_FLIP_NONE, pool->color[i]);
 	}
 
-	/* restore colour */
-	SDL_SetTextureColorMod(basicTexture->texture, 255, 255, 255);
+	setDrawLayer(LAYER_OVERLAY);
 }
 
 void addCoinParticles(int x, int y)
 {
-	Particle *p;
-	int i;
+	ParticlePool *pool;
+	int i, p, first;
+
+	pool = &stage.particles;
+
+	first = spawnParticles(12);
 
 	for (i = 0 ; i < 12 ; i++)
 	{
-		p = spawnParticle();
+		p = first + i;
 
-		p->x = x;
-		p->y = y;
+		pool->x[p] = x;
+		pool->y[p] = y;
 
-		p->dx = 100 - (rand() % 200);
-		p->dx /= 100;
+		pool->dx[p] = 100 - (rand() % 200);
+		pool->dx[p] /= 100;
 
-		p->dy = 100 - (rand() % 200);
-		p->dy /= 100;
+		pool->dy[p] = 100 - (rand() % 200);
+		pool->dy[p] /= 100;
 
-		p->atlasImage = basicTexture;
+		pool->life[p] = 15 + rand() % 45;
+		pool->gravity[p] = 0;
 
-		p->life = 15 + rand() % 45;
-		p->weightless = 1;
-
-		p->color.r = 255;
-		p->color.g = 255;
-		p->color.b = rand() % 255;
+		pool->color[p].r = 255;
+		pool->color[p].g = 255;
+		pool->color[p].b = rand() % 255;
 	}
 }
 
 void addPowerupParticles(int x, int y)
 {
-	Particle *p;
-	int i;
+	ParticlePool *pool;
+	int i, p, first;
+
+	pool = &stage.particles;
+
+	first = spawnParticles(25);
 
 	for (i = 0 ; i < 25 ; i++)
 	{
-		p = spawnParticle();
+		p = first + i;
 
-		p->x = x;
-		p->y = y;
+		pool->x[p] = x;
+		pool->y[p] = y;
 
-		p->dx = 200 - (rand() % 400);
-		p->dx /= 100;
+		pool->dx[p] = 200 - (rand() % 400);
+		pool->dx[p] /= 100;
 
-		p->dy = 200 - (rand() % 400);
-		p->dy /= 100;
+		pool->dy[p] = 200 - (rand() % 400);
+		pool->dy[p] /= 100;
 
-		p->atlasImage = basicTexture;
+		pool->life[p] = 15 + rand() % 15;
+		pool->gravity[p] = 0;
 
-		p->life = 15 + rand() % 15;
-		p->weightless = 1;
-
-		p->color.r = 64 + rand() % 64;
-		p->color.g = 128 + rand() % 128;
-		p->color.b = 255;
+		pool->color[p].r = 64 + rand() % 64;
+		pool->color[p].g = 128 + rand() % 128;
+		pool->color[p].b = 255;
 	}
 }
 
 void addToiletSplashParticles(int x, int y)
 {
-	Particle *p;
-	int i;
+	ParticlePool *pool;
+	int i, p, first;
+
+	pool = &stage.particles;
+
+	first = spawnParticles(20);
 
 	for (i = 0 ; i < 20 ; i++)
 	{
-		p = spawnParticle();
+		p = first + i;
 
-		p->x = x;
-		p->y = y;
+		pool->x[p] = x;
+		pool->y[p] = y;
 
-		p->dx = 150 - (rand() % 300);
-		p->dx /= 100;
+		pool->dx[p] = 150 - (rand() % 300);
+		pool->dx[p] /= 100;
 
-		p->dy = -(200 + rand() % 400);
-		p->dy /= 100;
+		pool->dy[p] = -(200 + rand() % 400);
+		pool->dy[p] /= 100;
 
-		p->atlasImage = basicTexture;
+		pool->life[p] = 15 + rand() % 30;
 
-		p->life = 15 + rand() % 30;
-
-		p->color.b = 255;
-		p->color.r = p->color.g = 128 + rand() % 128;
+		pool->color[p].b = 255;
+		pool->color[p].r = pool->color[p].g = 128 + rand() % 128;
 	}
 }
 
 void addDeathParticles(int x, int y)
 {
-	Particle *p;
-	int i;
+	ParticlePool *pool;
+	int i, p, first;
+
+	pool = &stage.particles;
+
+	first = spawnParticles(100);
 
 	for (i = 0 ; i < 100 ; i++)
 	{
-		p = spawnParticle();
+		p = first + i;
 
-		p->x = x;
-		p->y = y;
+		pool->x[p] = x;
+		pool->y[p] = y;
 
-		p->dx = 200 - (rand() % 400);
-		p->dx /= 100;
+		pool->dx[p] = 200 - (rand() % 400);
+		pool->dx[p] /= 100;
 
-		p->dy = -(200 + rand() % 600);
-		p->dy /= 100;
+		pool->dy[p] = -(200 + rand() % 600);
+		pool->dy[p] /= 100;
 
-		p->atlasImage = basicTexture;
+		pool->life[p] = 15 + rand() % 45;
 
-		p->life = 15 + rand() % 45;
-
-		p->color.r = 255;
-		p->color.g = p->color.b = 128 + rand() % 128;
+		pool->color[p].r = 255;
+		pool->color[p].g = pool->color[p].b = 128 + rand() % 128;
 	}
 }
 
 void addWaterBurstParticles(int x, int y)
 {
-	Particle *p;
-	int i;
+	ParticlePool *pool;
+	int i, p, first;
+
+	pool = &stage.particles;
+
+	first = spawnParticles(12);
 
 	for (i = 0 ; i < 12 ; i++)
 	{
-		p = spawnParticle();
+		p = first + i;
 
-		p->x = x;
-		p->y = y;
+		pool->x[p] = x;
+		pool->y[p] = y;
 
-		p->dx = 200 - (rand() % 400);
-		p->dx /= 100;
+		pool->dx[p] = 200 - (rand() % 400);
+		pool->dx[p] /= 100;
 
-		p->dy = 200 - (rand() % 400);
-		p->dy /= 100;
+		pool->dy[p] = 200 - (rand() % 400);
+		pool->dy[p] /= 100;
 
-		p->atlasImage = basicTexture;
+		pool->life[p] = 15 + rand() % 15;
 
-		p->life = 15 + rand() % 15;
-
-		p->color.b = 255;
-		p->color.r = p->color.g = 128 + rand() % 128;
+		pool->color[p].b = 255;
+		pool->color[p].r = pool->color[p].g = 128 + rand() % 128;
 	}
 }
 
 void addSlimeBurstParticles(int x, int y)
 {
-	Particle *p;
-	int i;
+	ParticlePool *pool;
+	int i, p, first;
+
+	pool = &stage.particles;
+
+	first = spawnParticles(12);
 
 	for (i = 0 ; i < 12 ; i++)
 	{
-		p = spawnParticle();
+		p = first + i;
 
-		p->x = x;
-		p->y = y;
+		pool->x[p] = x;
+		pool->y[p] = y;
 
-		p->dx = 200 - (rand() % 400);
-		p->dx /= 100;
+		pool->dx[p] = 200 - (rand() % 400);
+		pool->dx[p] /= 100;
 
-		p->dy = 200 - (rand() % 400);
-		p->dy /= 100;
+		pool->dy[p] = 200 - (rand() % 400);
+		pool->dy[p] /= 100;
 
-		p->atlasImage = basicTexture;
+		pool->life[p] = 15 + rand() % 15;
 
-		p->life = 15 + rand() % 15;
-
-		p->color.g = 255;
-		p->color.r = p->color.b = rand() % 255;
+		pool->color[p].g = 255;
+		pool->color[p].r = pool->color[p].b = rand() % 255;
 	}
 }
 
-static Particle *spawnParticle(void)
+/* reserves n particles at the end of the pool, dropping the oldest ones if it would overflow */
+static int spawnParticles(int n)
 {
-	Particle *p;
+	ParticlePool *pool;
+	int i, excess;
 
-	p = malloc(sizeof(Particle));
-	memset(p, 0, sizeof(Particle));
-	stage.particleTail->next = p;
-	stage.particleTail = p;
+	pool = &stage.particles;
 
-	return p;
-}
+	n = MIN(n, MAX_PARTICLES);
 
-void destroyParticles(void)
-{
-	Particle *p;
+	excess = pool->numParticles + n - MAX_PARTICLES;
+
+	if (excess > 0)
+	{
+		pool->numParticles -= excess;
+
+		memmove(pool->x, pool->x + excess, pool->numParticles * sizeof(float));
+		memmove(pool->y, pool->y + excess, pool->numParticles * sizeof(float));
+		memmove(pool->dx, pool->dx + excess, pool->numParticles * sizeof(float));
+		memmove(pool->dy, pool->dy + excess, pool->numParticles * sizeof(float));
+		memmove(pool->gravity, pool->gravity + excess, pool->numParticles * sizeof(float));
+		memmove(pool->life, pool->life + excess, pool->numParticles * sizeof(int));
+		memmove(pool->color, pool->color + excess, pool->numParticles * sizeof(SDL_Color));
+	}
 
-	while (stage.particleHead.next)
+	for (i = pool->numParticles ; i < pool->numParticles + n ; i++)
 	{
-		p = stage.particleHead.next;
-		stage.particleHead.next = p->next;
-		free(p);
+		pool->gravity[i] = 0.25;
+		pool->color[i].a = 255;
 	}
+
+	i = pool->numParticles;
+
+	pool->numParticles += n;
+
+	return i;
+}
+
+void destroyParticles(void)
+{
+	stage.particles.numParticles = 0;
 }
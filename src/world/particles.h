@@ -20,7 +20,14 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "../common.h"
 
-extern void blitAtlasImage(AtlasImage *atlasImage, int x, int y, int center, SDL_RendererFlip flip);
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define PARTICLES_SSE
+#include <xmmintrin.h>
+#endif
+
+extern void blitAtlasImageColor(AtlasImage *atlasImage, int x, int y, int center, SDL_RendererFlip flip, SDL_Color color);
 extern AtlasImage *getAtlasImage(char *filename, int required);
+extern void getDrawCamera(int *x, int *y);
+extern void setDrawLayer(int layer);
 
 extern Stage stage;
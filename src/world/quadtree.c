@@ -20,144 +20,146 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "quadtree.h"
 
-static int getIndex(Quadtree *root, int x, int y, int w, int h);
-static void removeEntity(Entity *e, Quadtree *root);
-static int entityComparator(const void *a, const void *b);
-static void getAllEntsWithinNode(int x, int y, int w, int h, Entity **candidates, Entity *ignore, Quadtree *root);
-static void destroyQuadtreeNode(Quadtree *root);
-static void resizeQTEntCapacity(Quadtree *root);
-
-static int cIndex;
-static int cCapacity;
-static int totalDepth;
-static int numCells;
+static int getIndex(QuadtreeNode *node, int x, int y, int w, int h);
+static void getAllEntsWithinNode(int x, int y, int w, int h, Quadtree *root, int n);
+static void resizeQTEntCapacity(Quadtree *root, QuadtreeNode *node);
+static int allocateQTSlots(Quadtree *root, int n);
 
+/* the whole tree is laid out breadth first, so the children of node n are at (n * 4) + 1 to (n * 4) + 4 */
 void initQuadtree(Quadtree *root)
 {
-	Quadtree *node;
-	int i, w, h;
+	QuadtreeNode *node, *parent;
+	int i, n, w, h, depth;
 
-	/* entire map */
-	if (root->depth == 0)
-	{
-		root->w = MAP_WIDTH * TILE_SIZE;
-		root->h = MAP_HEIGHT * TILE_SIZE;
-		root->capacity = QT_INITIAL_CAPACITY;
-		root->ents = malloc(sizeof(Entity*) * root->capacity);
-		memset(root->ents, 0, sizeof(Entity*) * root->capacity);
+	w = MAP_WIDTH * TILE_SIZE;
+	h = MAP_HEIGHT * TILE_SIZE;
+
+	depth = 0;
 
-		totalDepth = 0;
-		numCells = 0;
+	while (w / 2 > QT_CELL_SIZE || h / 2 > QT_CELL_SIZE)
+	{
+		w /= 2;
+		h /= 2;
 
-		cIndex = 0;
-		cCapacity = QT_INITIAL_CAPACITY;
+		depth++;
 	}
 
-	w = root->w / 2;
-	h = root->h / 2;
+	root->numNodes = ((1 << (2 * (depth + 1))) - 1) / 3;
+	root->firstLeaf = ((1 << (2 * depth)) - 1) / 3;
 
-	if (w > QT_CELL_SIZE || h > QT_CELL_SIZE)
-	{
-		for (i = 0 ; i < 4 ; i++)
-		{
-			node = malloc(sizeof(Quadtree));
-			memset(node, 0, sizeof(Quadtree));
-			root->node[i] = node;
+	root->nodes = malloc(sizeof(QuadtreeNode) * root->numNodes);
+	memset(root->nodes, 0, sizeof(QuadtreeNode) * root->numNodes);
 
-			node->depth = root->depth + 1;
-			node->capacity = QT_INITIAL_CAPACITY;
-			node->ents = malloc(sizeof(Entity*) * node->capacity);
-			memset(node->ents, 0, sizeof(Entity*) * node->capacity);
+	root->nodes[0].w = MAP_WIDTH * TILE_SIZE;
+	root->nodes[0].h = MAP_HEIGHT * TILE_SIZE;
 
-			totalDepth = MAX(node->depth, totalDepth);
-			numCells++;
+	for (n = 1 ; n < root->numNodes ; n++)
+	{
+		node = &root->nodes[n];
+		parent = &root->nodes[(n - 1) / 4];
 
-			switch (i)
-			{
-				case 0:
-					node->x = root->x;
-					node->y = root->y;
-					node->w = w;
-					node->h = h;
-					break;
-
-				case 1:
-					node->x = root->x + w;
-					node->y = root->y;
-					node->w = w;
-					node->h = h;
-					break;
-
-				case 2:
-					node->x = root->x;
-					node->y = root->y + h;
-					node->w = w;
-					node->h = h;
-					break;
-
-				default:
-					node->x = root->x + w;
-					node->y = root->y + h;
-					node->w = w;
-					node->h = h;
-					break;
-			}
+		i = (n - 1) % 4;
 
-			initQuadtree(node);
-		}
+		node->w = parent->w / 2;
+		node->h = parent->h / 2;
+		node->x = parent->x + (i % 2 == 1 ? node->w : 0);
+		node->y = parent->y + (i >= 2 ? node->h : 0);
 	}
 
-	if (root->depth == 0)
-	{
-		SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_DEBUG, "Quadtree: [totalDepth = %d, numCells = %d, memory = %ldkb]\n", totalDepth, numCells, (sizeof(Quadtree) * numCells) / 1024);
-	}
+	/* entity slots are only handed out to nodes when something is first added to them */
+	root->slotCapacity = QT_INITIAL_SLOTS;
+	root->slots = malloc(sizeof(Entity*) * root->slotCapacity);
+	root->numSlots = 0;
+
+	SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_DEBUG, "Quadtree: [totalDepth = %d, numCells = %d, memory = %ldkb]\n", depth, root->numNodes, (long)(sizeof(QuadtreeNode) * root->numNodes) / 1024);
 }
 
 void addToQuadtree(Entity *e, Quadtree *root)
 {
-	int index;
+	QuadtreeNode *node;
+	int n, index;
 
-	root->addedTo = 1;
+	n = 0;
 
-	if (root->node[0])
+	while (1)
 	{
-		index = getIndex(root, e->x, e->y, e->w, e->h);
+		node = &root->nodes[n];
+
+		node->addedTo = 1;
+
+		if (n >= root->firstLeaf)
+		{
+			break;
+		}
 
-		if (index != -1)
+		index = getIndex(node, e->broadphase.x, e->broadphase.y, e->broadphase.w, e->broadphase.h);
+
+		if (index == -1)
 		{
-			addToQuadtree(e, root->node[index]);
-			return;
+			break;
 		}
+
+		n = (n * 4) + 1 + index;
 	}
 
-	if (root->numEnts == root->capacity)
+	if (node->numEnts == node->capacity)
 	{
-		resizeQTEntCapacity(root);
+		resizeQTEntCapacity(root, node);
 	}
 
-	root->ents[root->numEnts++] = e;
+	e->broadphase.node = n;
+	e->broadphase.slot = node->numEnts;
+
+	root->slots[node->ents + node->numEnts++] = e;
 }
 
-static void resizeQTEntCapacity(Quadtree *root)
+/* a full node moves to a new block twice the size. The old block is not reused until the tree is destroyed */
+static void resizeQTEntCapacity(Quadtree *root, QuadtreeNode *node)
 {
-	int n;
+	int n, slot;
 
-	n = root->capacity + QT_INITIAL_CAPACITY;
+	n = node->capacity > 0 ? node->capacity * 2 : QT_INITIAL_CAPACITY;
 
-	SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_DEBUG, "Resizing QT node: %d -> %d", root->capacity, n);
+	if (node->capacity > 0)
+	{
+		SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_DEBUG, "Resizing QT node: %d -> %d", node->capacity, n);
+	}
+
+	slot = allocateQTSlots(root, n);
+
+	memcpy(&root->slots[slot], &root->slots[node->ents], sizeof(Entity*) * node->numEnts);
+
+	node->ents = slot;
+	node->capacity = n;
+}
+
+static int allocateQTSlots(Quadtree *root, int n)
+{
+	int slot, capacity;
+
+	if (root->numSlots + n > root->slotCapacity)
+	{
+		capacity = MAX(root->slotCapacity * 2, root->numSlots + n);
+
+		root->slots = resize(root->slots, sizeof(Entity*) * root->slotCapacity, sizeof(Entity*) * capacity);
+		root->slotCapacity = capacity;
+	}
+
+	slot = root->numSlots;
+
+	root->numSlots += n;
 
-	root->ents = resize(root->ents, sizeof(Entity*) * root->capacity, sizeof(Entity*) * n);
-	root->capacity = n;
+	return slot;
 }
 
-static int getIndex(Quadtree *root, int x, int y, int w, int h)
+static int getIndex(QuadtreeNode *node, int x, int y, int w, int h)
 {
 	int index, verticalMidpoint, horizontalMidpoint, topQuadrant, bottomQuadrant;
 
 	index = -1;
 
-	verticalMidpoint = root->x + (root->w / 2);
-	horizontalMidpoint = root->y + (root->h / 2);
+	verticalMidpoint = node->x + (node->w / 2);
+	horizontalMidpoint = node->y + (node->h / 2);
 	topQuadrant = (y < horizontalMidpoint && y + h < horizontalMidpoint);
 	bottomQuadrant = (y > horizontalMidpoint);
 
@@ -187,148 +189,83 @@ static int getIndex(Quadtree *root, int x, int y, int w, int h)
 	return index;
 }
 
+/* entities know which node and slot they were added to, so nothing needs to be searched */
 void removeFromQuadtree(Entity *e, Quadtree *root)
 {
-	int index;
-
-	if (root->addedTo)
-	{
-		if (root->node[0])
-		{
-			index = getIndex(root, e->x, e->y, e->w, e->h);
-
-			if (index != -1)
-			{
-				removeFromQuadtree(e, root->node[index]);
-				return;
-			}
-		}
+	QuadtreeNode *node;
+	Entity *last;
+	int n;
 
-		removeEntity(e, root);
+	n = e->broadphase.node;
 
-		if (root->numEnts == 0)
-		{
-			root->addedTo = 0;
+	node = &root->nodes[n];
 
-			if (root->node[0])
-			{
-				root->addedTo = root->node[0]->addedTo || root->node[1]->addedTo || root->node[2]->addedTo || root->node[3]->addedTo;
-			}
-		}
-	}
-}
+	node->numEnts--;
 
-static void removeEntity(Entity *e, Quadtree *root)
-{
-	int i, n;
+	last = root->slots[node->ents + node->numEnts];
+	last->broadphase.slot = e->broadphase.slot;
 
-	n = root->numEnts;
+	root->slots[node->ents + e->broadphase.slot] = last;
 
-	for (i = 0 ; i < root->capacity ; i++)
+	if (node->numEnts == 0)
 	{
-		if (root->ents[i] == e)
+		node->addedTo = 0;
+
+		if (n < root->firstLeaf)
 		{
-			root->ents[i] = NULL;
-			root->numEnts--;
+			n = (n * 4) + 1;
+
+			node->addedTo = root->nodes[n].addedTo || root->nodes[n + 1].addedTo || root->nodes[n + 2].addedTo || root->nodes[n + 3].addedTo;
 		}
 	}
-
-	qsort(root->ents, n, sizeof(Entity*), entityComparator);
 }
 
-Entity **getAllEntsWithin(int x, int y, int w, int h, Entity **candidates, Entity *ignore)
+void getAllEntsWithinQuadtree(Quadtree *root, int x, int y, int w, int h)
 {
-	cIndex = 0;
-
-	memset(candidates, 0, sizeof(Entity*) * MAX_QT_CANDIDATES);
-
-	getAllEntsWithinNode(x, y, w, h, candidates, ignore, &stage.quadtree);
-
-	return candidates;
+	getAllEntsWithinNode(x, y, w, h, root, 0);
 }
 
-static void getAllEntsWithinNode(int x, int y, int w, int h, Entity **candidates, Entity *ignore, Quadtree *root)
+static void getAllEntsWithinNode(int x, int y, int w, int h, Quadtree *root, int n)
 {
+	QuadtreeNode *node;
+	Entity **ents;
 	int index, i;
 
-	if (root->addedTo)
+	node = &root->nodes[n];
+
+	if (node->addedTo)
 	{
-		if (root->node[0])
+		if (n < root->firstLeaf)
 		{
-			index = getIndex(root, x, y, w, h);
+			index = getIndex(node, x, y, w, h);
 
 			if (index != -1)
 			{
-				getAllEntsWithinNode(x, y, w, h, candidates, ignore, root->node[index]);
+				getAllEntsWithinNode(x, y, w, h, root, (n * 4) + 1 + index);
 			}
 			else
 			{
 				for (i = 0 ; i < 4 ; i++)
 				{
-					getAllEntsWithinNode(x, y, w, h, candidates, ignore, root->node[i]);
+					getAllEntsWithinNode(x, y, w, h, root, (n * 4) + 1 + i);
 				}
 			}
 		}
 
-		for (i = 0 ; i < root->numEnts ; i++)
+		ents = &root->slots[node->ents];
+
+		for (i = 0 ; i < node->numEnts ; i++)
 		{
-			if (cIndex < MAX_QT_CANDIDATES)
-			{
-				if (root->ents[i] != ignore)
-				{
-					candidates[cIndex++] = root->ents[i];
-				}
-			}
-			else
-			{
-				SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_CRITICAL, "Out of quadtree candidate space (%d)", MAX_QT_CANDIDATES);
-				exit(1);
-			}
+			addCandidate(ents[i]);
 		}
 	}
 }
 
-void destroyQuadtree(void)
-{
-	destroyQuadtreeNode(&stage.quadtree);
-}
-
-static void destroyQuadtreeNode(Quadtree *root)
+void destroyQuadtree(Quadtree *root)
 {
-	int i;
-
-	free(root->ents);
-
-	root->ents = NULL;
-
-	if (root->node[0])
-	{
-		for (i = 0 ; i < 4 ; i++)
-		{
-			destroyQuadtreeNode(root->node[i]);
-
-			free(root->node[i]);
+	free(root->nodes);
 
-			root->node[i] = NULL;
-		}
-	}
-}
+	free(root->slots);
 
-static int entityComparator(const void *a, const void *b)
-{
-	Entity *e1 = *((Entity**)a);
-	Entity *e2 = *((Entity**)b);
-
-	if (!e1)
-    {
-        return 1;
-    }
-    else if (!e2)
-	{
-		return -1;
-	}
-    else
-	{
-		return 0;
-	}
+	memset(root, 0, sizeof(Quadtree));
 }
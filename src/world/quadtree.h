@@ -22,7 +22,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #define QT_CELL_SIZE           128
 #define QT_INITIAL_CAPACITY    8
+#define QT_INITIAL_SLOTS       256
 
+extern void addCandidate(Entity *e);
 extern void *resize(void *array, int oldSize, int newSize);
-
-extern Stage stage;
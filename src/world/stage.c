@@ -31,6 +31,7 @@ static void doControls(void);
 static void doTimeLimit(void);
 static void initTips(cJSON *root);
 static void initBackgroundData(void);
+static void drawBackgroundTile(int mx, int my, int x, int y);
 static void doTips(void);
 static void drawTips(void);
 static void doGame(void);
@@ -61,16 +62,18 @@ static Widget *optionsWidget;
 static Widget *quitWidget;
 static Widget *previousWidget;
 static int backgroundData[MAP_WIDTH][MAP_HEIGHT];
+static ChunkCache backgroundChunks;
 
 void initStage(void)
 {
+	pauseRendering();
+
 	app.delegate.logic = logic;
 	app.delegate.draw = draw;
 
 	memset(&stage, 0, sizeof(Stage));
 
 	stage.entityTail = &stage.entityHead;
-	stage.particleTail = &stage.particleHead;
 	stage.cloneDataTail = &stage.cloneDataHead;
 
 	resumeWidget = getWidget("resume", "stage");
@@ -92,6 +95,10 @@ void initStage(void)
 
 	backgroundTile = getAtlasImage("gfx/tilesets/brick/0.png", 1);
 
+	backgroundChunks.drawTile = drawBackgroundTile;
+
+	invalidateChunks(&backgroundChunks);
+
 	tipsPrompt = getAtlasImage("gfx/main/tips.png", 1);
 
 	game.stats[STAT_STAGES_STARTED]++;
@@ -109,6 +116,8 @@ void loadStage(int randomTiles)
 	char *json;
 	char filename[MAX_FILENAME_LENGTH];
 
+	pauseRendering();
+
 	srand(256 * stage.num);
 
 	sprintf(filename, "data/stages/%03d.json", stage.num);
@@ -128,7 +137,7 @@ void loadStage(int randomTiles)
 
 	initMap(root);
 
-	initQuadtree(&stage.quadtree);
+	initBroadphase();
 
 	initEntities(root);
 
@@ -146,6 +155,39 @@ void loadStage(int randomTiles)
 	stageJSON = root;
 }
 
+/* loads a stage for simulation only - no widgets, wipes, sounds or saving */
+void initStageSimulation(int num)
+{
+	memset(&stage, 0, sizeof(Stage));
+
+	stage.entityTail = &stage.entityHead;
+	stage.cloneDataTail = &stage.cloneDataHead;
+
+	stage.num = num;
+
+	loadStage(1);
+}
+
+/* the parts of doGame that don't depend on input or presentation */
+void doStageSimulation(void)
+{
+	doEntities();
+
+	doParticles();
+
+	stage.frame++;
+
+	if (stage.reset)
+	{
+		resetStage();
+	}
+
+	if (stage.status == SS_INCOMPLETE && stage.time > 0)
+	{
+		doTimeLimit();
+	}
+}
+
 static void logic(void)
 {
 	if (doWipe())
@@ -401,18 +443,16 @@ static void draw(void)
 
 static void drawGame()
 {
-	app.dev.drawing = 0;
+	setDrawLayer(LAYER_BACKGROUND);
 
 	drawRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, 64, 64, 64, 64);
 
 	drawBackground();
 
-	drawEntities(1);
+	drawEntities();
 
 	drawMap();
 
-	drawEntities(0);
-
 	drawParticles();
 
 	drawHud();
@@ -434,37 +474,30 @@ static void drawMenu()
 	drawWidgets("stage");
 }
 
+void invalidateBackgroundChunks(void)
+{
+	invalidateChunks(&backgroundChunks);
+}
+
 /* draws a parallax background */
 static void drawBackground(void)
 {
-	int x, y, x1, x2, y1, y2, mx, my, camX;
+	int camX, camY;
 
-	camX = stage.camera.x * 0.5f;
+	getDrawCamera(&camX, &camY);
 
-	x1 = (camX % TILE_SIZE) * -1;
-	x2 = x1 + MAP_RENDER_WIDTH * TILE_SIZE + (x1 == 0 ? 0 : TILE_SIZE);
+	setDrawLayer(LAYER_BACKGROUND);
 
-	y1 = (stage.camera.y % TILE_SIZE) * -1;
-	y2 = y1 + MAP_RENDER_HEIGHT * TILE_SIZE + (y1 == 0 ? 0 : TILE_SIZE);
+	drawChunks(&backgroundChunks, camX * 0.5f, camY);
 
-	mx = camX / TILE_SIZE;
-	my = stage.camera.y / TILE_SIZE;
+	setDrawLayer(LAYER_OVERLAY);
+}
 
-	for (y = y1 ; y < y2 ; y += TILE_SIZE)
+static void drawBackgroundTile(int mx, int my, int x, int y)
+{
+	if (backgroundData[mx][my] == 1)
 	{
-		for (x = x1 ; x < x2 ; x += TILE_SIZE)
-		{
-			if (backgroundData[mx][my] == 1)
-			{
-				blitAtlasImage(backgroundTile, x, y, 0, SDL_FLIP_NONE);
-			}
-
-			mx++;
-		}
-
-		mx = camX / TILE_SIZE;
-
-		my++;
+		renderAtlasImage(backgroundTile, x, y, SDL_FLIP_NONE);
 	}
 }
 
@@ -595,7 +628,7 @@ static void destroyCloneData(void)
 
 void destroyStage(void)
 {
-	destroyQuadtree();
+	destroyBroadphase();
 
 	destroyEntities();
 
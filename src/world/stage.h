@@ -31,15 +31,16 @@ extern void calculateWidgetFrame(const char *groupName);
 extern const char *getFileLocation(const char *filename);
 extern void clearAcceptControls(void);
 extern void clearControl(int type);
+extern void destroyBroadphase(void);
 extern void destroyEntities(void);
 extern void destroyParticles(void);
-extern void destroyQuadtree(void);
 extern void doCamera(void);
 extern void doEntities(void);
 extern void doParticles(void);
 extern void doWidgets(const char *groupName);
 extern int doWipe(void);
-extern void drawEntities(int background);
+extern void drawChunks(ChunkCache *cache, int camX, int camY);
+extern void drawEntities(void);
 extern void drawMap(void);
 extern void drawOutlineRect(int x, int y, int w, int h, int r, int g, int b, int a);
 extern void drawParticles(void);
@@ -50,28 +51,33 @@ extern void drawWidgets(const char *groupName);
 extern void drawWipe(void);
 extern void dropToFloor(void);
 extern AtlasImage *getAtlasImage(char *filename, int required);
+extern void getDrawCamera(int *x, int *y);
 extern StageMeta *getStageMeta(int n);
 extern Widget *getWidget(const char *name, const char *groupName);
+extern void initBroadphase(void);
 extern void initClone(void);
 extern void initEnding(void);
 extern void initEntities(cJSON *root);
 extern void initMap(cJSON *root);
 extern void initOptions(void (*done)(void));
-extern void initQuadtree(Quadtree *root);
 extern void initStats(void (*done)(void));
 extern void initTitle(void);
 extern void initWipe(int type);
+extern void invalidateChunks(ChunkCache *cache);
 extern int isAcceptControl(void);
 extern int isControl(int type);
 extern void loadRandomStageMusic(void);
+extern void pauseRendering(void);
 extern void pauseSound(void);
 extern void playSound(int snd, int ch);
 extern void randomizeTiles(void);
 extern char *readFile(const char *filename);
+extern void renderAtlasImage(AtlasImage *atlasImage, int x, int y, SDL_RendererFlip flip);
 extern void resetClones(void);
 extern void resetEntities(void);
 extern void resumeSound(void);
 extern void saveGame(void);
+extern void setDrawLayer(int layer);
 extern void showWidgets(const char *groupName, int visible);
 
 extern App app;
@@ -0,0 +1,114 @@
+/*
+Copyright (C) 2019 Parallel Realities
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "wiring.h"
+
+static void addToWire(Wire *wire, Entity *e);
+
+/* finds the wire for a target name, creating an empty one if nothing has asked for it yet */
+Wire *getWire(char *name)
+{
+	Wire *wire, *prev;
+
+	prev = &stage.wireHead;
+
+	for (wire = stage.wireHead.next ; wire != NULL ; wire = wire->next)
+	{
+		if (strcmp(wire->name, name) == 0)
+		{
+			return wire;
+		}
+
+		prev = wire;
+	}
+
+	wire = malloc(sizeof(Wire));
+	memset(wire, 0, sizeof(Wire));
+	prev->next = wire;
+
+	STRNCPY(wire->name, name, MAX_NAME_LENGTH);
+
+	wire->capacity = WIRE_INITIAL_CAPACITY;
+	wire->targets = malloc(sizeof(Entity*) * wire->capacity);
+
+	return wire;
+}
+
+/* called once the stage's entities are loaded, so that switches never have to search for their targets */
+void wireEntities(void)
+{
+	Entity *e;
+
+	for (e = stage.entityHead.next ; e != NULL ; e = e->next)
+	{
+		if (e->ops->activate)
+		{
+			addToWire(getWire(e->name), e);
+		}
+	}
+}
+
+static void addToWire(Wire *wire, Entity *e)
+{
+	int n;
+
+	if (wire->numTargets == wire->capacity)
+	{
+		n = wire->capacity * 2;
+
+		wire->targets = resize(wire->targets, sizeof(Entity*) * wire->capacity, sizeof(Entity*) * n);
+
+		wire->capacity = n;
+	}
+
+	wire->targets[wire->numTargets++] = e;
+}
+
+void activeEntities(Wire *wire, int active)
+{
+	Entity *oldSelf;
+	int i;
+
+	oldSelf = self;
+
+	for (i = 0 ; i < wire->numTargets ; i++)
+	{
+		self = wire->targets[i];
+
+		wakeEntity(self);
+
+		self->ops->activate(active);
+	}
+
+	self = oldSelf;
+}
+
+void destroyWiring(void)
+{
+	Wire *wire;
+
+	while (stage.wireHead.next)
+	{
+		wire = stage.wireHead.next;
+		stage.wireHead.next = wire->next;
+		free(wire->targets);
+		free(wire);
+	}
+}